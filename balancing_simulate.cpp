@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        balancing_simulate.cpp
+ * @brief       Command line front end of the event-driven balancing simulator
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread balancing_simulate.cpp balancing_simulator.cpp ecm_simulator.cpp \
+ *             current_profile.cpp -o balancing_simulate
+ *
+ * Usage:  balancing_simulate [options]
+ *   --profile daily|step|pwm|<file.csv>  module current profile, repeated --cycles times; daily is
+ *                                   2 h charge / 10 h rest / 2 h discharge / 10 h rest at C/3
+ *                                   (default: daily)
+ *   --config <battery.config>       module config for the step/pwm generators
+ *                                   (default: battery_E60_module.config)
+ *   --cycles <n>                    profile repetitions (default: 90)
+ *   --soc0 <x>                      mean initial SOC (default: 0.15)
+ *   --soc-sigma <x>                 initial SOC spread (default: 0.01)
+ *   --self-discharge <A>            mean leakage current (default: 0.005)
+ *   --seed <n>                      cell spread seed (default: 1)
+ *   --diff-max <V>                  uCellDiffMax override
+ *   --hysteresis <V>                uCellDiffHysteresis override
+ *   --min-voltage <V>               uCellMinBalancingVoltage override
+ *   --balancing-current <A>         bleed current (default: 0.1)
+ *   --dwell <s>                     minimum on/off time of a cell (default: 1)
+ *   --sweep-hysteresis lo:hi:step   run one simulation per hysteresis value in parallel
+ *   --threads <n>                   sweep threads (default: hardware concurrency)
+ *   --fixed-step <s>                also run the fixed-step reference for comparison
+ *   --per-cell                      print the statistics of every cell
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "balancing_simulator.h"
+#include "battery_traits.h"
+#include "current_profile.h"
+#include "thread_pool.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: balancing_simulate [--profile daily|step|pwm|<file.csv>] [--config file] [--cycles n]\n"
+                 "                          [--soc0 x] [--soc-sigma x] [--self-discharge A] [--seed n]\n"
+                 "                          [--diff-max V] [--hysteresis V] [--min-voltage V]\n"
+                 "                          [--balancing-current A] [--dwell s] [--sweep-hysteresis lo:hi:step]\n"
+                 "                          [--threads n] [--fixed-step s] [--per-cell]\n");
+}
+
+stabl::CurrentProfile daily_profile(double current)
+{
+    return {{0.0, -current}, {7200.0, 0.0}, {43200.0, current}, {50400.0, 0.0}, {86400.0, 0.0}};
+}
+
+void print_report(const char* label, const stabl::BalancingReport& r, double wall)
+{
+    std::printf("%-12s %8.1f d  duty %.4f %%  energy %9.3f Wh  starts %7zu  oscillations %7zu  "
+                "derated %8.0f s  cutoffs %4zu  spread %.4f  events %10zu",
+                label, r.simulated_time / 86400.0, 100.0 * r.duty(), r.energy_wh(), r.starts(), r.oscillations(),
+                r.derated_time, r.derating_cutoffs, r.soc_spread(), r.events);
+    if (wall > 0.0)
+        std::printf("  %.3f s", wall);
+    std::putchar('\n');
+}
+
+template <typename F>
+double timed(F&& fn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using Traits = stabl::LgE60Traits;
+
+    std::string profile_name = "daily";
+    std::string config_path = "battery_E60_module.config";
+    std::size_t cycles = 90;
+    std::size_t threads = 0;
+    double fixed_step = 0.0;
+    bool per_cell = false;
+    bool sweep = false;
+    double sweep_lo = 0.0, sweep_hi = 0.0, sweep_step = 0.0;
+    stabl::BalancingSpread spread;
+    spread.soc0 = 0.15;
+    stabl::BalancingPack pack = stabl::balancing_pack<Traits>();
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--profile") && has_value) {
+            profile_name = argv[++i];
+        } else if (!std::strcmp(argv[i], "--config") && has_value) {
+            config_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--cycles") && has_value) {
+            cycles = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--soc0") && has_value) {
+            spread.soc0 = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--soc-sigma") && has_value) {
+            spread.soc_sigma = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--self-discharge") && has_value) {
+            spread.self_discharge = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && has_value) {
+            spread.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--diff-max") && has_value) {
+            pack.policy.diff_max = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--hysteresis") && has_value) {
+            pack.policy.diff_hysteresis = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--min-voltage") && has_value) {
+            pack.policy.min_voltage = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--balancing-current") && has_value) {
+            pack.policy.current = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--dwell") && has_value) {
+            pack.policy.min_dwell = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--sweep-hysteresis") && has_value) {
+            sweep = std::sscanf(argv[++i], "%lf:%lf:%lf", &sweep_lo, &sweep_hi, &sweep_step) == 3 && sweep_step > 0.0;
+            if (!sweep) {
+                usage();
+                return 2;
+            }
+        } else if (!std::strcmp(argv[i], "--threads") && has_value) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--fixed-step") && has_value) {
+            fixed_step = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--per-cell")) {
+            per_cell = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    try {
+        stabl::CurrentProfile profile;
+        if (profile_name == "daily") {
+            profile = daily_profile(Traits::kCapacityAh / 3.0);
+        } else if (profile_name == "step" || profile_name == "pwm") {
+            const stabl::EcmParameters params = stabl::load_ecm_parameters(config_path);
+            profile = profile_name == "step" ? stabl::generate_step_discharge_profile(params)
+                                             : stabl::generate_step_discharge_profile_pwm(params);
+        } else {
+            profile = stabl::load_current_profile(profile_name);
+        }
+
+        const std::vector<stabl::BalancingCell> cells = stabl::make_balancing_cells(
+            Traits::kNumCells, Traits::kCapacityAh, Traits::kR0 / static_cast<double>(Traits::kNumCells), spread);
+        std::printf("%zu cells, %zu OCV knots, diff_max %.3f V, hysteresis %.3f V, min voltage %.3f V\n", cells.size(),
+                    pack.ocv_soc.size(), pack.policy.diff_max, pack.policy.diff_hysteresis, pack.policy.min_voltage);
+
+        if (sweep) {
+            std::vector<double> values;
+            for (double h = sweep_lo; h <= sweep_hi + 1e-12; h += sweep_step)
+                values.push_back(h);
+            std::vector<stabl::BalancingReport> reports(values.size());
+            stabl::ThreadPool pool(threads);
+            const double wall = timed([&] {
+                pool.parallel_for(values.size(), [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t k = begin; k < end; ++k) {
+                        stabl::BalancingPack p = pack;
+                        p.policy.diff_hysteresis = values[k];
+                        reports[k] = stabl::BalancingSimulator(std::move(p), cells).run(profile, cycles);
+                    }
+                });
+            });
+            for (std::size_t k = 0; k < values.size(); ++k) {
+                char label[32];
+                std::snprintf(label, sizeof(label), "hyst %.3f", values[k]);
+                print_report(label, reports[k], 0.0);
+            }
+            std::printf("%zu policies in %.3f s on %zu threads\n", values.size(), wall, pool.size());
+            return 0;
+        }
+
+        const stabl::BalancingSimulator sim(pack, cells);
+        stabl::BalancingReport report;
+        const double wall = timed([&] { report = sim.run(profile, cycles); });
+        print_report("event", report, wall);
+        if (fixed_step > 0.0) {
+            stabl::BalancingReport reference;
+            const double ref_wall = timed([&] { reference = sim.run_fixed_step(profile, cycles, fixed_step); });
+            print_report("fixed-step", reference, ref_wall);
+            std::printf("speedup %.0fx\n", ref_wall / wall);
+        }
+        if (per_cell) {
+            for (std::size_t i = 0; i < report.cells.size(); ++i) {
+                const stabl::BalancingCellStats& c = report.cells[i];
+                std::printf("cell %2zu: balancing %9.0f s, %8.3f Wh, starts %5zu, oscillations %5zu, soc %.4f\n", i,
+                            c.balancing_time, c.energy_wh, c.starts, c.oscillations, c.final_soc);
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "balancing_simulate: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,638 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        balancing_simulator.cpp
+ * @brief       Event-driven simulator of the passive cell balancing policy of battery_info.h
+ */
+#include "balancing_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace stabl {
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kNone = -1.0;
+/* Voltage differences within this are treated as equal, so that a crossing that was just
+ * handled is not found again because of rounding [V] */
+constexpr double kVoltageEps = 1e-9;
+
+/** Interval [lo, hi) of x >= 0; lo = inf if empty. */
+struct Interval {
+    double lo;
+    double hi;
+};
+
+/* Where a + s*x < c for x >= 0 */
+Interval below(double a, double s, double c)
+{
+    double d = a - c;
+    if (std::fabs(d) <= kVoltageEps)
+        d = 0.0;
+    if (s > 0.0)
+        return d < 0.0 ? Interval{0.0, -d / s} : Interval{kInf, kInf};
+    if (s < 0.0)
+        return d < 0.0 ? Interval{0.0, kInf} : Interval{d / -s, kInf};
+    return d < 0.0 ? Interval{0.0, kInf} : Interval{kInf, kInf};
+}
+
+/* Where a + s*x > c for x >= 0 */
+Interval above(double a, double s, double c)
+{
+    return below(-a, -s, -c);
+}
+
+/** Profile repeated @p cycles times, walked segment by segment. */
+class SegmentCursor {
+public:
+    SegmentCursor(const CurrentProfile& profile, std::size_t cycles)
+        : profile_(profile), cycles_(cycles), period_(profile.back().time - profile.front().time)
+    {
+        skip_empty();
+    }
+
+    bool done() const { return cycle_ >= cycles_; }
+    double current() const { return profile_[index_].current; }
+    double end_time() const { return offset() + profile_[index_ + 1].time - profile_.front().time; }
+    double total_time() const { return static_cast<double>(cycles_) * period_; }
+
+    void next()
+    {
+        ++index_;
+        skip_empty();
+    }
+
+private:
+    double offset() const { return static_cast<double>(cycle_) * period_; }
+
+    void skip_empty()
+    {
+        for (;;) {
+            if (index_ + 1 >= profile_.size()) {
+                index_ = 0;
+                ++cycle_;
+            }
+            if (done() || profile_[index_ + 1].time > profile_[index_].time)
+                return;
+            ++index_;
+        }
+    }
+
+    const CurrentProfile& profile_;
+    std::size_t cycles_;
+    double period_;
+    std::size_t index_ = 0;
+    std::size_t cycle_ = 0;
+};
+
+/** State shared by the event-driven and the fixed-step run. */
+class PackState {
+public:
+    PackState(const BalancingPack& pack, const std::vector<BalancingCell>& cells, double oscillation_window)
+        : pack_(pack), cells_(cells), window_(oscillation_window), n_(cells.size()),
+          last_change_(cells.size(), -kInf), last_stop_(cells.size(), kNone)
+    {
+        soc_.resize(n_);
+        balancing_.assign(n_, 0);
+        for (std::size_t i = 0; i < n_; ++i)
+            soc_[i] = cells[i].soc;
+        report_.cells.resize(n_);
+    }
+
+    std::size_t size() const { return n_; }
+    const BalancingPolicy& policy() const { return pack_.policy; }
+    const BalancingPack& pack() const { return pack_; }
+
+    /** Piece of the OCV curve used at @p soc when moving down (SOC decreasing) or up */
+    std::size_t piece(double soc, bool down) const
+    {
+        const auto& x = pack_.ocv_soc;
+        const std::size_t pieces = x.size() - 1;
+        std::size_t k;
+        if (down)
+            k = static_cast<std::size_t>(std::lower_bound(x.begin(), x.end(), soc) - x.begin());
+        else
+            k = static_cast<std::size_t>(std::upper_bound(x.begin(), x.end(), soc) - x.begin());
+        return std::min(pieces - 1, k == 0 ? 0 : k - 1);
+    }
+
+    const std::vector<double>& branch() const
+    {
+        return current_ < 0.0 ? pack_.ocv_charge : pack_.ocv_discharge;
+    }
+
+    double slope(std::size_t k) const
+    {
+        const auto& x = pack_.ocv_soc;
+        const auto& y = branch();
+        return (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+    }
+
+    double ocv(double soc, std::size_t k) const
+    {
+        return branch()[k] + slope(k) * (soc - pack_.ocv_soc[k]);
+    }
+
+    /** SOC decrease per second */
+    double rate(std::size_t i) const
+    {
+        const double i_cell = current_ + (balancing_[i] ? pack_.policy.current : 0.0) + cells_[i].self_discharge;
+        return i_cell / (3600.0 * cells_[i].capacity_ah);
+    }
+
+    double voltage(std::size_t i, std::size_t k) const
+    {
+        return ocv(soc_[i], k) - cells_[i].resistance * current_;
+    }
+
+    double voltage(std::size_t i) const { return voltage(i, piece(soc_[i], rate(i) >= 0.0)); }
+
+    void start(std::size_t i, double t)
+    {
+        BalancingCellStats& s = report_.cells[i];
+        ++s.starts;
+        if (last_stop_[i] != kNone && t - last_stop_[i] < window_)
+            ++s.oscillations;
+        balancing_[i] = 1;
+        last_change_[i] = t;
+    }
+
+    void stop(std::size_t i, double t)
+    {
+        balancing_[i] = 0;
+        last_change_[i] = t;
+        last_stop_[i] = t;
+    }
+
+    /** Time left until cell @p i may change its balancing state */
+    double dwell_left(std::size_t i, double t) const
+    {
+        return std::max(0.0, last_change_[i] + pack_.policy.min_dwell - t);
+    }
+
+    BalancingReport finish(double t)
+    {
+        report_.simulated_time = t;
+        for (std::size_t i = 0; i < n_; ++i)
+            report_.cells[i].final_soc = soc_[i];
+        return std::move(report_);
+    }
+
+    std::vector<double> soc_;
+    std::vector<char> balancing_;
+    double current_ = 0.0;          /**< Module current actually flowing [A] */
+    bool enabled_ = false;          /**< Lowest cell at or above min_voltage */
+    bool derated_ = false;
+    bool cut_off_ = false;
+    BalancingReport report_;
+
+private:
+    const BalancingPack& pack_;
+    const std::vector<BalancingCell>& cells_;
+    double window_;
+    std::size_t n_;
+    std::vector<double> last_change_;
+    std::vector<double> last_stop_;
+};
+
+enum class Action { EnableOn, EnableOff, Start, Stop, DerateOn, DerateOff, Cutoff };
+
+struct Pending {
+    double x = kInf;                /**< Time from now [s] */
+    Action action = Action::EnableOn;
+    std::size_t cell = 0;
+
+    void consider(double at, Action a, std::size_t c)
+    {
+        if (at < x) {
+            x = at;
+            action = a;
+            cell = c;
+        }
+    }
+};
+
+/** Structural event in the queue; knot events are stale once the cell's epoch moved on. */
+struct Event {
+    double time;
+    std::size_t cell;               /**< kSegmentEnd for the end of a profile segment */
+    std::uint64_t epoch;
+
+    bool operator>(const Event& other) const { return time > other.time; }
+};
+
+constexpr std::size_t kSegmentEnd = static_cast<std::size_t>(-1);
+
+/* Earliest x >= 0 where "exists i: a_i + s_i*x < c" holds */
+template <typename F>
+double first_any(std::size_t n, F&& interval)
+{
+    double x = kInf;
+    for (std::size_t i = 0; i < n; ++i)
+        x = std::min(x, interval(i).lo);
+    return x;
+}
+
+/* Earliest x >= @p from where the intervals of all i overlap */
+template <typename F>
+double first_all(std::size_t n, double from, F&& interval)
+{
+    double lo = from;
+    double hi = kInf;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Interval iv = interval(i);
+        lo = std::max(lo, iv.lo);
+        hi = std::min(hi, iv.hi);
+    }
+    return lo < hi ? lo : kInf;
+}
+
+} // namespace
+
+void set_balancing_ocv(BalancingPack& pack, const float* ocv_charge, const float* ocv_discharge,
+                       std::size_t points, double tolerance)
+{
+    if (points < 2)
+        throw std::runtime_error("balancing OCV needs at least two points");
+
+    const double step = 1.0 / static_cast<double>(points - 1);
+    auto fits = [&](std::size_t a, std::size_t b) {
+        for (const float* y : {ocv_charge, ocv_discharge}) {
+            const double slope = (static_cast<double>(y[b]) - y[a]) / static_cast<double>(b - a);
+            for (std::size_t k = a + 1; k < b; ++k)
+                if (std::fabs(y[a] + slope * static_cast<double>(k - a) - y[k]) > tolerance)
+                    return false;
+        }
+        return true;
+    };
+
+    /* Greedy: extend every piece as far as the tolerance allows */
+    pack.ocv_soc.clear();
+    pack.ocv_charge.clear();
+    pack.ocv_discharge.clear();
+    std::size_t a = 0;
+    for (;;) {
+        pack.ocv_soc.push_back(static_cast<double>(a) * step);
+        pack.ocv_charge.push_back(ocv_charge[a]);
+        pack.ocv_discharge.push_back(ocv_discharge[a]);
+        if (a == points - 1)
+            break;
+        std::size_t b = a + 1;
+        while (b + 1 < points && fits(a, b + 1))
+            ++b;
+        a = b;
+    }
+}
+
+std::vector<BalancingCell> make_balancing_cells(std::size_t num_cells, double capacity_ah, double resistance,
+                                                const BalancingSpread& spread)
+{
+    std::mt19937 rng(spread.seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<BalancingCell> cells(num_cells);
+    for (BalancingCell& c : cells) {
+        c.soc = std::min(1.0, std::max(0.0, spread.soc0 + spread.soc_sigma * normal(rng)));
+        c.capacity_ah = capacity_ah * std::max(0.5, 1.0 + spread.capacity_sigma * normal(rng));
+        c.resistance = resistance * std::max(0.1, 1.0 + spread.resistance_sigma * normal(rng));
+        c.self_discharge = spread.self_discharge * std::max(0.0, 1.0 + spread.self_discharge_sigma * normal(rng));
+    }
+    return cells;
+}
+
+double BalancingReport::duty() const
+{
+    if (cells.empty() || !(simulated_time > 0.0))
+        return 0.0;
+    double t = 0.0;
+    for (const auto& c : cells)
+        t += c.balancing_time;
+    return t / (simulated_time * static_cast<double>(cells.size()));
+}
+
+double BalancingReport::energy_wh() const
+{
+    double e = 0.0;
+    for (const auto& c : cells)
+        e += c.energy_wh;
+    return e;
+}
+
+std::size_t BalancingReport::starts() const
+{
+    std::size_t n = 0;
+    for (const auto& c : cells)
+        n += c.starts;
+    return n;
+}
+
+std::size_t BalancingReport::oscillations() const
+{
+    std::size_t n = 0;
+    for (const auto& c : cells)
+        n += c.oscillations;
+    return n;
+}
+
+double BalancingReport::soc_spread() const
+{
+    if (cells.empty())
+        return 0.0;
+    double lo = kInf;
+    double hi = -kInf;
+    for (const auto& c : cells) {
+        lo = std::min(lo, c.final_soc);
+        hi = std::max(hi, c.final_soc);
+    }
+    return hi - lo;
+}
+
+BalancingSimulator::BalancingSimulator(BalancingPack pack, std::vector<BalancingCell> cells, double oscillation_window)
+    : pack_(std::move(pack)), cells_(std::move(cells)), oscillation_window_(oscillation_window)
+{
+    if (pack_.ocv_soc.size() < 2 || pack_.ocv_charge.size() != pack_.ocv_soc.size() ||
+        pack_.ocv_discharge.size() != pack_.ocv_soc.size())
+        throw std::runtime_error("balancing pack needs an OCV curve");
+    if (cells_.empty())
+        throw std::runtime_error("balancing simulator needs at least one cell");
+    for (const BalancingCell& c : cells_)
+        if (!(c.capacity_ah > 0.0))
+            throw std::runtime_error("balancing simulator needs positive cell capacities");
+    if (!(pack_.policy.min_dwell > 0.0))
+        throw std::runtime_error("balancing policy needs a positive minimum dwell time");
+}
+
+BalancingReport BalancingSimulator::run(const CurrentProfile& profile, std::size_t cycles) const
+{
+    if (profile.size() < 2)
+        throw std::runtime_error("balancing simulation needs a profile with at least two points");
+
+    PackState st(pack_, cells_, oscillation_window_);
+    const BalancingPolicy& policy = pack_.policy;
+    const double stop_diff = policy.diff_max - policy.diff_hysteresis;
+    const std::size_t n = st.size();
+    SegmentCursor segment(profile, cycles);
+    double t = 0.0;
+    if (segment.done())
+        return st.finish(t);
+
+    /* Per-cell line v_i + g_i*x valid until the cell's next knot */
+    std::vector<double> v(n);
+    std::vector<double> g(n);
+    std::vector<std::size_t> pieces(n);
+    std::vector<std::uint64_t> epoch(n, 0);
+    std::vector<Event> heap;
+    const auto later = std::greater<Event>();
+
+    auto push = [&](const Event& e) {
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end(), later);
+    };
+    auto valid = [&](const Event& e) { return e.cell == kSegmentEnd || e.epoch == epoch[e.cell]; };
+
+    /* Recompute the line and the next knot of cell i after its SOC rate changed */
+    auto schedule_knot = [&](std::size_t i) {
+        const double r = st.rate(i);
+        const bool down = r >= 0.0;
+        const std::size_t k = st.piece(st.soc_[i], down);
+        pieces[i] = k;
+        ++epoch[i];
+        const auto& x = pack_.ocv_soc;
+        double dt = kInf;
+        if (r > 0.0 && x[k] < st.soc_[i])
+            dt = (st.soc_[i] - x[k]) / r;
+        else if (r < 0.0 && x[k + 1] > st.soc_[i])
+            dt = (x[k + 1] - st.soc_[i]) / -r;
+        if (dt < kInf)
+            push(Event{t + dt, i, epoch[i]});
+    };
+
+    auto begin_segment = [&]() {
+        st.cut_off_ = false;
+        st.current_ = segment.current();
+        push(Event{segment.end_time(), kSegmentEnd, 0});
+        for (std::size_t i = 0; i < n; ++i)
+            schedule_knot(i);
+    };
+    begin_segment();
+
+    for (;;) {
+        while (!valid(heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            heap.pop_back();
+        }
+        /* Stale knots of cells that toggled often pile up; drop them now and then */
+        if (heap.size() > 8 * (n + 1)) {
+            heap.erase(std::remove_if(heap.begin(), heap.end(), [&](const Event& e) { return !valid(e); }),
+                       heap.end());
+            std::make_heap(heap.begin(), heap.end(), later);
+        }
+        const double horizon = heap.front().time - t;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            v[i] = st.voltage(i, pieces[i]);
+            g[i] = -st.rate(i) * st.slope(pieces[i]);
+        }
+
+        /* Next threshold crossing with the lines as they are */
+        Pending p;
+        if (st.enabled_) {
+            p.consider(first_any(n, [&](std::size_t i) { return below(v[i], g[i], policy.min_voltage); }),
+                       Action::EnableOff, 0);
+        } else {
+            p.consider(first_all(n, 0.0, [&](std::size_t i) { return above(v[i], g[i], policy.min_voltage); }),
+                       Action::EnableOn, 0);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!st.balancing_[i] && !st.enabled_)
+                continue;
+            const double dwell = st.dwell_left(i, t);
+            if (!st.balancing_[i]) {
+                double x = kInf;
+                for (std::size_t j = 0; j < n; ++j) {
+                    if (j == i)
+                        continue;
+                    const Interval iv = above(v[i] - v[j], g[i] - g[j], policy.diff_max);
+                    const double lo = std::max(iv.lo, dwell);
+                    if (lo < iv.hi)
+                        x = std::min(x, lo);
+                }
+                p.consider(x, Action::Start, i);
+            } else {
+                p.consider(first_all(n, dwell, [&](std::size_t j) {
+                               return j == i ? Interval{0.0, kInf} : below(v[i] - v[j], g[i] - g[j], stop_diff);
+                           }),
+                           Action::Stop, i);
+            }
+        }
+        if (st.current_ > 0.0) {
+            const double one = pack_.discharge_derating_one;
+            if (!st.derated_)
+                p.consider(first_any(n, [&](std::size_t i) { return below(v[i], g[i], one); }), Action::DerateOn, 0);
+            else
+                p.consider(first_all(n, 0.0, [&](std::size_t i) { return above(v[i], g[i], one); }),
+                           Action::DerateOff, 0);
+            p.consider(first_any(n, [&](std::size_t i) { return below(v[i], g[i], pack_.discharge_derating_zero); }),
+                       Action::Cutoff, 0);
+        } else if (st.current_ < 0.0) {
+            const double one = pack_.charge_derating_one;
+            if (!st.derated_)
+                p.consider(first_any(n, [&](std::size_t i) { return above(v[i], g[i], one); }), Action::DerateOn, 0);
+            else
+                p.consider(first_all(n, 0.0, [&](std::size_t i) { return below(v[i], g[i], one); }),
+                           Action::DerateOff, 0);
+            p.consider(first_any(n, [&](std::size_t i) { return above(v[i], g[i], pack_.charge_derating_zero); }),
+                       Action::Cutoff, 0);
+        } else if (st.derated_) {
+            p.consider(0.0, Action::DerateOff, 0);
+        }
+
+        /* Advance everything to the earlier of the crossing and the queue head */
+        const bool crossing = p.x <= horizon;
+        const double dt = crossing ? p.x : horizon;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (st.balancing_[i]) {
+                BalancingCellStats& s = st.report_.cells[i];
+                s.balancing_time += dt;
+                s.energy_wh += policy.current * (v[i] + 0.5 * g[i] * dt) * dt / 3600.0;
+            }
+            st.soc_[i] -= st.rate(i) * dt;
+        }
+        if (st.derated_)
+            st.report_.derated_time += dt;
+        t += dt;
+        ++st.report_.events;
+
+        if (crossing) {
+            switch (p.action) {
+            case Action::EnableOn:
+                st.enabled_ = true;
+                break;
+            case Action::EnableOff:
+                st.enabled_ = false;
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (st.balancing_[i]) {
+                        st.stop(i, t);
+                        schedule_knot(i);
+                    }
+                }
+                break;
+            case Action::Start:
+                st.start(p.cell, t);
+                schedule_knot(p.cell);
+                break;
+            case Action::Stop:
+                st.stop(p.cell, t);
+                schedule_knot(p.cell);
+                break;
+            case Action::DerateOn:
+                st.derated_ = true;
+                break;
+            case Action::DerateOff:
+                st.derated_ = false;
+                break;
+            case Action::Cutoff:
+                ++st.report_.derating_cutoffs;
+                st.cut_off_ = true;
+                st.current_ = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                    schedule_knot(i);
+                break;
+            }
+            continue;
+        }
+
+        const Event e = heap.front();
+        std::pop_heap(heap.begin(), heap.end(), later);
+        heap.pop_back();
+        if (e.cell == kSegmentEnd) {
+            segment.next();
+            if (segment.done())
+                break;
+            begin_segment();
+        } else {
+            /* Land exactly on the knot so that the next piece is picked */
+            st.soc_[e.cell] = pack_.ocv_soc[st.rate(e.cell) > 0.0 ? pieces[e.cell] : pieces[e.cell] + 1];
+            schedule_knot(e.cell);
+        }
+    }
+    return st.finish(t);
+}
+
+BalancingReport BalancingSimulator::run_fixed_step(const CurrentProfile& profile, std::size_t cycles, double dt) const
+{
+    if (profile.size() < 2)
+        throw std::runtime_error("balancing simulation needs a profile with at least two points");
+    if (!(dt > 0.0))
+        throw std::runtime_error("balancing simulation needs a positive step");
+
+    PackState st(pack_, cells_, oscillation_window_);
+    const BalancingPolicy& policy = pack_.policy;
+    const double stop_diff = policy.diff_max - policy.diff_hysteresis;
+    const std::size_t n = st.size();
+    SegmentCursor segment(profile, cycles);
+    const double t_end = segment.total_time();
+    std::vector<double> v(n);
+
+    double t = 0.0;
+    std::size_t steps = 0;
+    while (!segment.done() && t < t_end) {
+        while (!segment.done() && segment.end_time() <= t) {
+            segment.next();
+            st.cut_off_ = false;
+        }
+        if (segment.done())
+            break;
+        st.current_ = st.cut_off_ ? 0.0 : segment.current();
+
+        double v_min = kInf;
+        double v_max = -kInf;
+        for (std::size_t i = 0; i < n; ++i) {
+            v[i] = st.voltage(i);
+            v_min = std::min(v_min, v[i]);
+            v_max = std::max(v_max, v[i]);
+        }
+        if ((st.current_ > 0.0 && v_min <= pack_.discharge_derating_zero) ||
+            (st.current_ < 0.0 && v_max >= pack_.charge_derating_zero)) {
+            ++st.report_.derating_cutoffs;
+            st.cut_off_ = true;
+            continue;
+        }
+        st.derated_ = (st.current_ > 0.0 && v_min < pack_.discharge_derating_one) ||
+                      (st.current_ < 0.0 && v_max > pack_.charge_derating_one);
+        st.enabled_ = v_min >= policy.min_voltage;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double diff = v[i] - v_min;
+            if (st.balancing_[i]) {
+                if (!st.enabled_ || (diff < stop_diff && st.dwell_left(i, t) <= 0.0))
+                    st.stop(i, t);
+            } else if (st.enabled_ && diff > policy.diff_max && st.dwell_left(i, t) <= 0.0) {
+                st.start(i, t);
+            }
+        }
+
+        const double h = std::min(dt, t_end - t);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (st.balancing_[i]) {
+                BalancingCellStats& s = st.report_.cells[i];
+                s.balancing_time += h;
+                s.energy_wh += policy.current * v[i] * h / 3600.0;
+            }
+            st.soc_[i] -= st.rate(i) * h;
+        }
+        if (st.derated_)
+            st.report_.derated_time += h;
+        t = static_cast<double>(++steps) * dt;
+    }
+    st.report_.events = steps;
+    return st.finish(std::min(t, t_end));
+}
+
+} // namespace stabl
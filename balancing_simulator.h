@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        balancing_simulator.h
+ * @brief       Event-driven simulator of the passive cell balancing policy of battery_info.h
+ *
+ * A cell starts balancing when its voltage exceeds the lowest cell voltage of the module by
+ * more than uCellDiffMax, provided the lowest cell is at or above uCellMinBalancingVoltage, and
+ * stops when the difference has dropped below uCellDiffMax - uCellDiffHysteresis.
+ *
+ * Each series cell is an OCV source with a series resistance, and its self-discharge is a
+ * constant leakage current. The OCV table is reduced to a piecewise linear curve within a
+ * voltage tolerance. For piecewise-constant currents every cell voltage is then linear in time
+ * between table knots. Threshold crossings are solved in closed form instead of being found by
+ * stepping. A priority queue holds the structural events (profile segment ends and per-cell knot
+ * crossings). After every event the next crossing of any threshold is computed: balancing
+ * start/stop, balancing enable, derating knee and derating cut-off. Long rest periods cost
+ * nothing, so months of operation need a few events per cycle instead of one step per second.
+ *
+ * Between uCell*DeratingOne and uCell*DeratingZero the current is not reduced, because that
+ * would make the trajectories non-linear. The time spent there is reported, and reaching the
+ * zero-rating voltage cuts the current until the next profile segment.
+ */
+#ifndef STABL_BALANCING_SIMULATOR_H
+#define STABL_BALANCING_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ecm_simulator.h"
+
+namespace stabl {
+
+/** Thresholds of the balancing decision, see uCellMinBalancingVoltage/uCellDiffMax/uCellDiffHysteresis. */
+struct BalancingPolicy {
+    double min_voltage = 0.0;       /**< Lowest cell voltage required to balance at all [V] */
+    double diff_max = 0.0;          /**< Start when v - v_min exceeds this [V] */
+    double diff_hysteresis = 0.0;   /**< Stop when v - v_min falls below diff_max - this [V] */
+    double current = 0.1;           /**< Bleed current of a balancing cell [A] */
+    double min_dwell = 1.0;         /**< Minimum on and off time of a cell, the BMS decision period [s] */
+};
+
+/** Battery type data the simulator needs, usually from balancing_pack<Traits>(). */
+struct BalancingPack {
+    std::vector<double> ocv_soc;        /**< Knots of the piecewise linear OCV, ascending SOC [0..1] */
+    std::vector<double> ocv_charge;     /**< OCV at each knot, charging branch [V] */
+    std::vector<double> ocv_discharge;  /**< OCV at each knot, discharging branch [V] */
+    double discharge_derating_zero = 0.0;
+    double discharge_derating_one = 0.0;
+    double charge_derating_one = 0.0;
+    double charge_derating_zero = 0.0;
+    BalancingPolicy policy;
+};
+
+/**
+ * @brief Reduce uniform-SOC OCV tables to the fewest knots that keep both branches within
+ *        @p tolerance volts of the table
+ */
+void set_balancing_ocv(BalancingPack& pack, const float* ocv_charge, const float* ocv_discharge,
+                       std::size_t points, double tolerance);
+
+/** Pack data and default policy of a battery type (see battery_traits.h). */
+template <typename Traits>
+BalancingPack balancing_pack(double ocv_tolerance = 1e-3)
+{
+    BalancingPack pack;
+    set_balancing_ocv(pack, Traits::ocv_charge, Traits::ocv_discharge, Traits::kOcvPoints, ocv_tolerance);
+    pack.discharge_derating_zero = Traits::kDischargeDeratingZero;
+    pack.discharge_derating_one = Traits::kDischargeDeratingOne;
+    pack.charge_derating_one = Traits::kChargeDeratingOne;
+    pack.charge_derating_zero = Traits::kChargeDeratingZero;
+    pack.policy.min_voltage = Traits::kBalancingMinVoltage;
+    pack.policy.diff_max = Traits::kBalancingDiffMax;
+    pack.policy.diff_hysteresis = Traits::kBalancingDiffHysteresis;
+    return pack;
+}
+
+/** One series element of the module (a parallel group of cells). */
+struct BalancingCell {
+    double soc = 0.5;               /**< [0..1] */
+    double capacity_ah = 0.0;       /**< [Ah] */
+    double resistance = 0.0;        /**< Series resistance [ohm] */
+    double self_discharge = 0.0;    /**< Leakage current [A] */
+};
+
+/** Cell-to-cell spread used by make_balancing_cells(). */
+struct BalancingSpread {
+    double soc0 = 0.5;                  /**< Mean initial SOC */
+    double soc_sigma = 0.01;            /**< Initial SOC spread (absolute) */
+    double capacity_sigma = 0.01;       /**< Capacity spread (relative) */
+    double resistance_sigma = 0.05;     /**< Resistance spread (relative) */
+    double self_discharge = 0.005;      /**< Mean leakage current [A] */
+    double self_discharge_sigma = 0.3;  /**< Leakage spread (relative) */
+    std::uint32_t seed = 1;             /**< RNG seed, equal seeds give equal modules */
+};
+
+std::vector<BalancingCell> make_balancing_cells(std::size_t num_cells, double capacity_ah, double resistance,
+                                                const BalancingSpread& spread = BalancingSpread());
+
+struct BalancingCellStats {
+    double balancing_time = 0.0;    /**< [s] */
+    double energy_wh = 0.0;         /**< Energy burned in the bleed resistor [Wh] */
+    std::size_t starts = 0;         /**< Balancing periods */
+    std::size_t oscillations = 0;   /**< Starts within the oscillation window after the previous stop */
+    double final_soc = 0.0;
+};
+
+struct BalancingReport {
+    std::vector<BalancingCellStats> cells;
+    double simulated_time = 0.0;    /**< [s] */
+    double derated_time = 0.0;      /**< Time with a cell beyond a DeratingOne knee [s] */
+    std::size_t derating_cutoffs = 0;
+    std::size_t events = 0;         /**< Events (or fixed steps) processed */
+
+    /** Fraction of cell-time spent balancing */
+    double duty() const;
+    double energy_wh() const;
+    std::size_t starts() const;
+    std::size_t oscillations() const;
+    /** Largest minus smallest final SOC */
+    double soc_spread() const;
+};
+
+class BalancingSimulator {
+public:
+    /** @p oscillation_window: a restart within this time after a stop counts as oscillation [s] */
+    BalancingSimulator(BalancingPack pack, std::vector<BalancingCell> cells, double oscillation_window = 3600.0);
+
+    /**
+     * @brief Run @p cycles repetitions of @p profile (module current, positive = discharge)
+     *
+     * Starts from the cells given to the constructor with balancing off, so one simulator can
+     * run several profiles. Throws std::runtime_error for profiles with fewer than two points.
+     */
+    BalancingReport run(const CurrentProfile& profile, std::size_t cycles = 1) const;
+
+    /** Reference implementation stepping every @p dt seconds, for validation and comparison. */
+    BalancingReport run_fixed_step(const CurrentProfile& profile, std::size_t cycles, double dt) const;
+
+    const BalancingPack& pack() const { return pack_; }
+    const std::vector<BalancingCell>& cells() const { return cells_; }
+
+private:
+    BalancingPack pack_;
+    std::vector<BalancingCell> cells_;
+    double oscillation_window_;
+};
+
+} // namespace stabl
+
+#endif /* STABL_BALANCING_SIMULATOR_H */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        battery_traits.h
+ * @brief       Compile-time view of battery_info.h for the C++ kernels
+ *
+ * battery_info.h describes one battery type through #defines and file-scope constants. The
+ * kernels are templates on a traits type instead, so every pack gets its own specialised code
+ * and several battery types can coexist in one host tool. A traits type provides:
+ *
+ *   kNumCells, kNumParallelCells, kNumParallelBat   module layout
+ *   kOcvPoints, ocv_charge, ocv_discharge           SOC -> OCV tables on a uniform SOC grid
+ *   kCapacityAh, kR0                                capacity [Ah] and module resistance [ohm]
+ *   kCellVoltageMin, kCellVoltageMax                cell operating window [V]
+ *   kBalancingMinVoltage, kBalancingDiffMax,
+ *   kBalancingDiffHysteresis                        passive balancing policy [V]
+ *   kDischargeDeratingZero/One,
+ *   kChargeDeratingOne/Zero                         voltage derating knees [V]
+ *   kMaxDeratingChargeCurrent/DischargeCurrent      current at derating rating 1 [A]
+ *   kChargeLimitPoints, charge_limit_v/_i,
+ *   kDischargeLimitPoints, discharge_limit_v/_i     operating current limit over cell voltage [V], [A];
+ *                                                   without DYNAMIC_CURRENT_OPL one constant point
+ *   kNumTempSensors, kTempMin, kTempMax             temperature window [degC]
+ *   cell_voltage_offsets                            cell voltage measurement offsets per series
+ *                                                   position [V]; zero without
+ *                                                   VOLTAGE_MEASUREMENT_COMPENSATION
+ *
+ * battery_info.h is shared with the firmware and includes its core_defines.h, which is not in
+ * this tree: a manual build needs -I<dir> of the firmware copy or of a stub defining
+ * IS_USED(x) as 0. CMakeLists.txt takes the directory from STABL_CORE_DEFINES_DIR and
+ * generates that stub otherwise.
+ */
+#ifndef STABL_BATTERY_TRAITS_H
+#define STABL_BATTERY_TRAITS_H
+
+#include <cstddef>
+
+#include "battery_info 1.h"
+
+namespace stabl {
+
+/** LG E60 module as described by battery_info.h */
+struct LgE60Traits {
+    static constexpr std::size_t kNumCells = NUM_CELLS;
+    static constexpr std::size_t kNumParallelCells = NUM_PARALLEL_CELLS;
+    static constexpr std::size_t kNumParallelBat = NUM_PARALLEL_BAT;
+
+    static constexpr std::size_t kOcvPoints = sizeof(OCVcharge) / sizeof(OCVcharge[0]);
+    static constexpr const float (&ocv_charge)[kOcvPoints] = OCVcharge;
+    static constexpr const float (&ocv_discharge)[kOcvPoints] = OCVdischarge;
+
+    static constexpr float kCapacityAh = batCap;
+    static constexpr float kR0 = batR0;
+    static constexpr float kCellVoltageMin = uCellMin;
+    static constexpr float kCellVoltageMax = uCellMax;
+
+    static constexpr float kBalancingMinVoltage = uCellMinBalancingVoltage;
+    static constexpr float kBalancingDiffMax = uCellDiffMax;
+    static constexpr float kBalancingDiffHysteresis = uCellDiffHysteresis;
+
+    static constexpr float kDischargeDeratingZero = uCellDischargeDeratingZero;
+    static constexpr float kDischargeDeratingOne = uCellDischargeDeratingOne;
+    static constexpr float kChargeDeratingOne = uCellChargeDeratingOne;
+    static constexpr float kChargeDeratingZero = uCellChargeDeratingZero;
+    static constexpr float kMaxDeratingChargeCurrent = maxDeratingChargeCurr;
+    static constexpr float kMaxDeratingDischargeCurrent = maxDeratingDischargeCurr;
+
+#ifdef DYNAMIC_CURRENT_OPL
+    static constexpr std::size_t kChargeLimitPoints = sizeof(maxOperateChargeCurrV) / sizeof(maxOperateChargeCurrV[0]);
+    static constexpr const float (&charge_limit_v)[kChargeLimitPoints] = maxOperateChargeCurrV;
+    static constexpr const float (&charge_limit_i)[kChargeLimitPoints] = maxOperateChargeCurrI;
+    static constexpr std::size_t kDischargeLimitPoints =
+        sizeof(maxOperateDischargeCurrV) / sizeof(maxOperateDischargeCurrV[0]);
+    static constexpr const float (&discharge_limit_v)[kDischargeLimitPoints] = maxOperateDischargeCurrV;
+    static constexpr const float (&discharge_limit_i)[kDischargeLimitPoints] = maxOperateDischargeCurrI;
+#else
+    static constexpr std::size_t kChargeLimitPoints = 1;
+    static constexpr float charge_limit_v[1] = {uCellMin};
+    static constexpr float charge_limit_i[1] = {maxOperateChargeCurr};
+    static constexpr std::size_t kDischargeLimitPoints = 1;
+    static constexpr float discharge_limit_v[1] = {uCellMin};
+    static constexpr float discharge_limit_i[1] = {maxOperateDischargeCurr};
+#endif
+
+    static constexpr std::size_t kNumTempSensors = NUM_TEMP_SENSORS;
+    static constexpr float kTempMin = tBatMin;
+    static constexpr float kTempMax = tBatMax;
+
+#ifdef VOLTAGE_MEASUREMENT_COMPENSATION
+    static constexpr const float (&cell_voltage_offsets)[kNumCells] = cellVoltMeasOffsets;
+#else
+    static constexpr float cell_voltage_offsets[kNumCells] = {};
+#endif
+};
+
+} // namespace stabl
+
+#endif /* STABL_BATTERY_TRAITS_H */
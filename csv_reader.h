@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        csv_reader.h
+ * @brief       Tokenizer for numeric CSV traces, shared by every CSV importer
+ *
+ * The first line names the columns. Every further non-empty line must have one field per
+ * column. Spaces around fields, quotes around names and CR line ends are ignored. Only the
+ * selected columns are parsed as numbers, so other columns may hold anything.
+ */
+#ifndef STABL_CSV_READER_H
+#define STABL_CSV_READER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stabl {
+
+class CsvReader {
+public:
+    /** Parse the header of [@p begin, @p end); @p name is used in error messages. */
+    CsvReader(const char* begin, const char* end, const std::string& name) : p_(begin), end_(end), name_(name)
+    {
+        while (p_ < end_ && *p_ != '\n') {
+            const char* f = p_;
+            while (p_ < end_ && *p_ != ',' && *p_ != '\n')
+                ++p_;
+            columns_.push_back(trim_name(f, p_));
+            if (p_ < end_ && *p_ == ',')
+                ++p_;
+        }
+        if (p_ < end_)
+            ++p_;
+        slot_.assign(columns_.size(), kSkip);
+    }
+
+    const std::vector<std::string>& columns() const { return columns_; }
+    /** Index of the column called @p column, or columns().size() if there is none. */
+    std::size_t column_index(const std::string& column) const
+    {
+        return static_cast<std::size_t>(std::find(columns_.begin(), columns_.end(), column) - columns_.begin());
+    }
+
+    /** Parse the columns @p selected into values[0..selected.size()) of every next() call. */
+    void select(const std::vector<std::size_t>& selected)
+    {
+        slot_.assign(columns_.size(), kSkip);
+        for (std::size_t i = 0; i < selected.size(); ++i)
+            slot_.at(selected[i]) = i;
+    }
+
+    /** Bytes not read yet, e.g. to reserve storage before the first row. */
+    std::size_t remaining() const { return static_cast<std::size_t>(end_ - p_); }
+    /** Line number of the last row returned by next(). */
+    std::size_t line() const { return line_; }
+
+    /** Read the next row into @p values; false at the end of the input. Throws on format errors. */
+    bool next(double* values)
+    {
+        while (p_ < end_ && (*p_ == '\n' || *p_ == '\r')) {
+            line_ += *p_ == '\n';
+            ++p_;
+        }
+        if (p_ >= end_)
+            return false;
+        ++line_;
+        for (std::size_t c = 0; c < columns_.size(); ++c) {
+            const char* f = p_;
+            while (p_ < end_ && *p_ != ',' && *p_ != '\n')
+                ++p_;
+            if (slot_[c] != kSkip) {
+                const char* e = p_;
+                while (f < e && *f == ' ')
+                    ++f;
+                while (e > f && (e[-1] == ' ' || e[-1] == '\r'))
+                    --e;
+                const auto r = std::from_chars(f, e, values[slot_[c]]);
+                if (r.ec != std::errc() || r.ptr != e || f == e)
+                    fail("bad number");
+            }
+            const bool last = c + 1 == columns_.size();
+            if (last ? p_ < end_ && *p_ != '\n' : p_ >= end_ || *p_ != ',')
+                fail("wrong number of fields");
+            if (p_ < end_)
+                ++p_;
+        }
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kSkip = static_cast<std::size_t>(-1);
+
+    static std::string trim_name(const char* begin, const char* end)
+    {
+        while (begin < end && (*begin == ' ' || *begin == '"'))
+            ++begin;
+        while (end > begin && (end[-1] == ' ' || end[-1] == '"' || end[-1] == '\r'))
+            --end;
+        return std::string(begin, end);
+    }
+
+    [[noreturn]] void fail(const char* what) const
+    {
+        throw std::runtime_error(std::string(what) + " in '" + name_ + "' line " + std::to_string(line_));
+    }
+
+    const char* p_;
+    const char* end_;
+    std::string name_;
+    std::vector<std::string> columns_;
+    std::vector<std::size_t> slot_;     /**< Output index per column, kSkip if not selected */
+    std::size_t line_ = 1;
+};
+
+} // namespace stabl
+
+#endif /* STABL_CSV_READER_H */
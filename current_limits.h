@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        current_limits.h
+ * @brief       Incremental SIMD evaluation of the module current limits (DYNAMIC_CURRENT_OPL, derating)
+ *
+ * The permitted module current is built from four piecewise linear curves over cell voltage.
+ * Two are the operating limits maxOperateCharge/DischargeCurrV/I. The other two are the voltage
+ * derating ramps maxDeratingCharge/DischargeCurr between uCellDischargeDeratingZero/One and
+ * uCellChargeDeratingOne/Zero. Each curve is reduced over all cells, most restrictive wins. The
+ * result is then cut to zero outside the temperature window tBatMin..tBatMax.
+ *
+ * Every curve is compiled into per-segment offset/slope pairs and into the equivalent hinge
+ * form y0 + sum_k h_k * max(0, v - x_k), which evaluates a whole vector of cells without a
+ * search or a gather. Most samples need no per-cell work at all. If no curve breakpoint lies
+ * between the lowest and the highest cell voltage, or the curve is monotonic across the
+ * breakpoints in between, the most restrictive cell is the lowest or the highest one. The
+ * limit is then one FMA on the cached segment. The segments of v_min/v_max and the resulting
+ * mode are only re-derived when one of them crosses a breakpoint. A full per-cell pass runs only
+ * for a non-monotonic span, e.g. the charge curve's -60/-100/-60 A hump.
+ *
+ * With parallel batteries all kNumCells * kNumParallelBat cells share one reduction and the
+ * limits are scaled by kNumParallelBat, assuming an even current split.
+ */
+#ifndef STABL_CURRENT_LIMITS_H
+#define STABL_CURRENT_LIMITS_H
+
+#include <cstddef>
+
+#include "simd_ops.h"
+
+namespace stabl {
+
+/**
+ * @brief Module current limits of one sample
+ *
+ * The field order is this engine's own. It is not known to match the FMU output i_mod_dr[0..4]:
+ * modelDescription.xml only declares five elements, and the names of the estimator's derating
+ * enum (HC_DR_IDCH_BAT_T_SOC, HC_DR_ICH_BAT_T_SOC, HC_DR_IDCH_VCELL, HC_DR_ICH_VCELL,
+ * HC_DR_I_MODULE_T in the Windows binary) suggest per-source limits instead. Compare by meaning,
+ * not by index, until the layout has been checked against the shipped estimator.
+ */
+struct CurrentLimits {
+    static constexpr std::size_t kSize = 5;
+
+    float charge;               /**< Permitted charge current, <= 0 [A] */
+    float discharge;            /**< Permitted discharge current, >= 0 [A] */
+    float charge_rating;        /**< Voltage derating of the charge direction [0..1] */
+    float discharge_rating;     /**< Voltage derating of the discharge direction [0..1] */
+    float temperature_rating;   /**< 1 inside the temperature window, else 0 */
+
+    /** Column names of store(), e.g. for CSV headers */
+    static constexpr const char* kNames[kSize] = {"charge", "discharge", "charge_rating", "discharge_rating",
+                                                  "temperature_rating"};
+
+    /** Write the fields to @p fields[0..kSize) in declaration order */
+    void store(double* fields) const
+    {
+        fields[0] = charge;
+        fields[1] = discharge;
+        fields[2] = charge_rating;
+        fields[3] = discharge_rating;
+        fields[4] = temperature_rating;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Piecewise linear curve, constant outside its breakpoints
+ *
+ * Segment s covers [x[s - 1], x[s]); segment 0 lies below x[0] and segment Points above x[Points - 1].
+ */
+template <std::size_t Points>
+struct LimitCurve {
+    static constexpr std::size_t kPoints = Points;
+    static constexpr std::size_t kSegments = Points + 1;
+    static constexpr std::size_t kHinges = Points > 1 ? Points - 1 : 1;
+
+    float x[Points];
+    float offset[kSegments];    /**< f(v) = offset[s] + slope[s] * v on segment s */
+    float slope[kSegments];
+    float hinge[kHinges];       /**< Slope change at x[k] */
+    float y0;
+    float x_last;
+
+    float at(float v, std::size_t s) const { return offset[s] + slope[s] * v; }
+
+    /** Segment of @p v, searched from the previous segment @p s */
+    std::size_t locate(float v, std::size_t s) const
+    {
+        while (s > 0 && v < x[s - 1])
+            --s;
+        while (s < Points && v >= x[s])
+            ++s;
+        return s;
+    }
+
+    /** Whether no segment in [lo, hi] falls (Rising) or rises (!Rising) */
+    bool monotonic(std::size_t lo, std::size_t hi, bool rising) const
+    {
+        for (std::size_t s = lo; s <= hi; ++s) {
+            if (rising ? slope[s] < 0.0f : slope[s] > 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+template <std::size_t Points>
+constexpr LimitCurve<Points> build_limit_curve(const float* x, const float* y)
+{
+    LimitCurve<Points> c{};
+    for (std::size_t k = 0; k < Points; ++k) {
+        if (k > 0 && !(x[k] > x[k - 1]))
+            throw "limit curve breakpoints must be increasing";   /* not a constant expression: fails the build */
+        c.x[k] = x[k];
+    }
+    c.y0 = y[0];
+    c.x_last = x[Points - 1];
+    c.offset[0] = y[0];
+    c.offset[Points] = y[Points - 1];
+    float previous = 0.0f;
+    for (std::size_t s = 1; s < Points; ++s) {
+        const float slope = (y[s] - y[s - 1]) / (x[s] - x[s - 1]);
+        c.slope[s] = slope;
+        c.offset[s] = y[s - 1] - slope * x[s - 1];
+        c.hinge[s - 1] = slope - previous;
+        previous = slope;
+    }
+    return c;
+}
+
+} // namespace detail
+
+template <typename Traits, typename O = simd::Native>
+class CurrentLimitEngine {
+public:
+    static constexpr std::size_t kNumCells = Traits::kNumCells * Traits::kNumParallelBat;
+    static constexpr std::size_t kNumTempSensors = Traits::kNumTempSensors;
+
+    CurrentLimitEngine() { reset(); }
+
+    /** Forget the cached segments, e.g. before replaying an unrelated trace. */
+    void reset()
+    {
+        for (CurveState& s : states_)
+            s = CurveState();
+        initialized_ = false;
+    }
+
+    /**
+     * @brief Limits for one sample
+     *
+     * @param cell_voltages kNumCells cell voltages [V]
+     * @param temperatures  kNumTempSensors temperatures [degC]
+     */
+    CurrentLimits update(const float* cell_voltages, const float* temperatures)
+    {
+        float v_min, v_max;
+        min_max(cell_voltages, v_min, v_max);
+        float t_min = temperatures[0], t_max = temperatures[0];
+        for (std::size_t i = 1; i < kNumTempSensors; ++i) {
+            t_min = temperatures[i] < t_min ? temperatures[i] : t_min;
+            t_max = temperatures[i] > t_max ? temperatures[i] : t_max;
+        }
+        return evaluate(v_min, v_max, t_min, t_max, cell_voltages);
+    }
+
+    /**
+     * @brief Limits from the extreme values only, for callers that track them already
+     *
+     * Exact whenever update() would not need a per-cell pass. Otherwise every breakpoint between
+     * v_min and v_max is treated as a possible cell voltage, which is never less restrictive.
+     */
+    CurrentLimits update(float v_min, float v_max, float t_min, float t_max)
+    {
+        return evaluate(v_min, v_max, t_min, t_max, nullptr);
+    }
+
+    /**
+     * @brief Batch form for offline replay of @p samples consecutive samples
+     *
+     * Rows of @p cell_voltages hold kNumCells values, rows of @p temperatures kNumTempSensors.
+     */
+    void update(const float* cell_voltages, const float* temperatures, std::size_t samples, CurrentLimits* out)
+    {
+        for (std::size_t k = 0; k < samples; ++k)
+            out[k] = update(cell_voltages + k * kNumCells, temperatures + k * kNumTempSensors);
+    }
+
+    /**
+     * @brief Batch form fed straight from a trace voltage column, e.g. of a mapped trace chunk
+     *
+     * Cell c of sample k is u_bat[k] * u_scale + cell_offsets[c], so no cell matrix has to be
+     * built. Rows of @p temperatures are @p temperature_stride apart; with a stride of 0 every
+     * sample uses the same sensor values.
+     */
+    void update(const double* u_bat, double u_scale, const double* cell_offsets, const float* temperatures,
+                std::size_t temperature_stride, std::size_t samples, CurrentLimits* out)
+    {
+        float cells[kNumCells];
+        for (std::size_t k = 0; k < samples; ++k) {
+            const double u = u_bat[k] * u_scale;
+            for (std::size_t c = 0; c < kNumCells; ++c)
+                cells[c] = static_cast<float>(u + cell_offsets[c]);
+            out[k] = update(cells, temperatures + k * temperature_stride);
+        }
+    }
+
+    /** Samples that re-derived at least one curve mode because v_min or v_max crossed a breakpoint */
+    std::size_t reclassifications() const { return reclassifications_; }
+    /** Samples that needed the per-cell pass */
+    std::size_t cell_passes() const { return cell_passes_; }
+
+private:
+    enum class Mode { Low, High, Cells };   /* most restrictive cell: lowest, highest, any */
+
+    struct CurveState {
+        std::size_t lo = 0;     /**< Segment of v_min */
+        std::size_t hi = 0;     /**< Segment of v_max */
+        Mode mode = Mode::Cells;
+    };
+
+    static constexpr float kChargeDeratingV[2] = {Traits::kChargeDeratingOne, Traits::kChargeDeratingZero};
+    static constexpr float kChargeDeratingI[2] = {Traits::kMaxDeratingChargeCurrent, 0.0f};
+    static constexpr float kDischargeDeratingV[2] = {Traits::kDischargeDeratingZero, Traits::kDischargeDeratingOne};
+    static constexpr float kDischargeDeratingI[2] = {0.0f, Traits::kMaxDeratingDischargeCurrent};
+
+    static constexpr auto kChargeLimit =
+        detail::build_limit_curve<Traits::kChargeLimitPoints>(Traits::charge_limit_v, Traits::charge_limit_i);
+    static constexpr auto kDischargeLimit =
+        detail::build_limit_curve<Traits::kDischargeLimitPoints>(Traits::discharge_limit_v, Traits::discharge_limit_i);
+    static constexpr auto kChargeDerating = detail::build_limit_curve<2>(kChargeDeratingV, kChargeDeratingI);
+    static constexpr auto kDischargeDerating = detail::build_limit_curve<2>(kDischargeDeratingV, kDischargeDeratingI);
+
+    /* Charge limits are negative, so the most restrictive cell has the largest value */
+    enum Curve { ChargeLimit, ChargeDerating, DischargeLimit, DischargeDerating, kNumCurves };
+    static constexpr bool kTakeMax[kNumCurves] = {true, true, false, false};
+
+    void min_max(const float* v, float& v_min, float& v_max) const
+    {
+        std::size_t i = 0;
+        v_min = v[0];
+        v_max = v[0];
+        if (kNumCells >= O::kWidth) {
+            typename O::V lo = O::loadu(v), hi = lo;
+            for (i = O::kWidth; i + O::kWidth <= kNumCells; i += O::kWidth) {
+                const typename O::V x = O::loadu(v + i);
+                lo = O::min(lo, x);
+                hi = O::max(hi, x);
+            }
+            v_min = O::reduce_min(lo);
+            v_max = O::reduce_max(hi);
+        }
+        for (; i < kNumCells; ++i) {
+            v_min = v[i] < v_min ? v[i] : v_min;
+            v_max = v[i] > v_max ? v[i] : v_max;
+        }
+    }
+
+    template <typename C>
+    void track(const C& curve, CurveState& state, bool take_max, float v_min, float v_max, bool& changed)
+    {
+        const std::size_t lo = curve.locate(v_min, state.lo);
+        const std::size_t hi = curve.locate(v_max, state.hi);
+        if (initialized_ && lo == state.lo && hi == state.hi)
+            return;
+        state.lo = lo;
+        state.hi = hi;
+        changed = true;
+        /* The largest value of a rising span sits at v_max, the smallest at v_min, and vice versa */
+        if (curve.monotonic(lo, hi, true))
+            state.mode = take_max ? Mode::High : Mode::Low;
+        else if (curve.monotonic(lo, hi, false))
+            state.mode = take_max ? Mode::Low : Mode::High;
+        else
+            state.mode = Mode::Cells;
+    }
+
+    /* Bound over [v_min, v_max] from the end points and the breakpoints in between */
+    template <typename C>
+    static float span_extreme(const C& curve, const CurveState& state, bool take_max, float v_min, float v_max)
+    {
+        float a = curve.at(v_min, state.lo);
+        const float b = curve.at(v_max, state.hi);
+        a = take_max ? (b > a ? b : a) : (b < a ? b : a);
+        for (std::size_t s = state.lo; s < state.hi; ++s) {
+            const float y = curve.at(curve.x[s], s + 1);
+            a = take_max ? (y > a ? y : a) : (y < a ? y : a);
+        }
+        return a;
+    }
+
+    template <typename C>
+    static float extreme(const C& curve, const CurveState& state, bool take_max, float v_min, float v_max)
+    {
+        if (state.mode == Mode::Low)
+            return curve.at(v_min, state.lo);
+        if (state.mode == Mode::High)
+            return curve.at(v_max, state.hi);
+        return span_extreme(curve, state, take_max, v_min, v_max);
+    }
+
+    template <typename P, typename C>
+    static typename P::V hinge(const C& curve, typename P::V v)
+    {
+        const typename P::V zero = P::set1(0.0f);
+        v = P::min(v, P::set1(curve.x_last));
+        typename P::V y = P::set1(curve.y0);
+        for (std::size_t k = 0; k + 1 < C::kPoints; ++k)
+            y = P::fmadd(P::set1(curve.hinge[k]), P::max(zero, P::sub(v, P::set1(curve.x[k]))), y);
+        return y;
+    }
+
+    /* One pass over the cells for every curve in Cells mode */
+    void cell_pass(const float* v, float (&result)[kNumCurves]) const
+    {
+        bool active[kNumCurves];
+        for (int c = 0; c < kNumCurves; ++c)
+            active[c] = states_[c].mode == Mode::Cells;
+        typename O::V acc[kNumCurves];
+        for (int c = 0; c < kNumCurves; ++c)
+            acc[c] = O::set1(kTakeMax[c] ? -3.0e38f : 3.0e38f);
+        const auto fold = [&](int c, typename O::V y) { acc[c] = kTakeMax[c] ? O::max(acc[c], y) : O::min(acc[c], y); };
+
+        std::size_t i = 0;
+        for (; i + O::kWidth <= kNumCells; i += O::kWidth) {
+            const typename O::V x = O::loadu(v + i);
+            if (active[ChargeLimit])
+                fold(ChargeLimit, hinge<O>(kChargeLimit, x));
+            if (active[ChargeDerating])
+                fold(ChargeDerating, hinge<O>(kChargeDerating, x));
+            if (active[DischargeLimit])
+                fold(DischargeLimit, hinge<O>(kDischargeLimit, x));
+            if (active[DischargeDerating])
+                fold(DischargeDerating, hinge<O>(kDischargeDerating, x));
+        }
+        for (int c = 0; c < kNumCurves; ++c) {
+            if (active[c])
+                result[c] = kTakeMax[c] ? O::reduce_max(acc[c]) : O::reduce_min(acc[c]);
+        }
+        for (; i < kNumCells; ++i) {
+            const float y[kNumCurves] = {hinge<simd::Scalar>(kChargeLimit, v[i]), hinge<simd::Scalar>(kChargeDerating, v[i]),
+                                         hinge<simd::Scalar>(kDischargeLimit, v[i]), hinge<simd::Scalar>(kDischargeDerating, v[i])};
+            for (int c = 0; c < kNumCurves; ++c) {
+                if (active[c])
+                    result[c] = kTakeMax[c] ? (y[c] > result[c] ? y[c] : result[c])
+                                            : (y[c] < result[c] ? y[c] : result[c]);
+            }
+        }
+    }
+
+    CurrentLimits evaluate(float v_min, float v_max, float t_min, float t_max, const float* cells)
+    {
+        bool changed = false;
+        track(kChargeLimit, states_[ChargeLimit], kTakeMax[ChargeLimit], v_min, v_max, changed);
+        track(kChargeDerating, states_[ChargeDerating], kTakeMax[ChargeDerating], v_min, v_max, changed);
+        track(kDischargeLimit, states_[DischargeLimit], kTakeMax[DischargeLimit], v_min, v_max, changed);
+        track(kDischargeDerating, states_[DischargeDerating], kTakeMax[DischargeDerating], v_min, v_max, changed);
+        initialized_ = true;
+        reclassifications_ += changed;
+
+        float y[kNumCurves] = {extreme(kChargeLimit, states_[ChargeLimit], true, v_min, v_max),
+                               extreme(kChargeDerating, states_[ChargeDerating], true, v_min, v_max),
+                               extreme(kDischargeLimit, states_[DischargeLimit], false, v_min, v_max),
+                               extreme(kDischargeDerating, states_[DischargeDerating], false, v_min, v_max)};
+        if (cells != nullptr) {
+            bool any = false;
+            for (const CurveState& s : states_)
+                any = any || s.mode == Mode::Cells;
+            if (any) {
+                cell_pass(cells, y);
+                ++cell_passes_;
+            }
+        }
+
+        const float scale = static_cast<float>(Traits::kNumParallelBat);
+        const float temperature = t_min >= Traits::kTempMin && t_max <= Traits::kTempMax ? 1.0f : 0.0f;
+        const float charge = y[ChargeLimit] > y[ChargeDerating] ? y[ChargeLimit] : y[ChargeDerating];
+        const float discharge = y[DischargeLimit] < y[DischargeDerating] ? y[DischargeLimit] : y[DischargeDerating];
+        CurrentLimits r;
+        r.charge = charge * temperature * scale + 0.0f;     /* + 0 turns -0 into 0 */
+        r.discharge = discharge * temperature * scale;
+        r.charge_rating = y[ChargeDerating] / Traits::kMaxDeratingChargeCurrent + 0.0f;
+        r.discharge_rating = y[DischargeDerating] / Traits::kMaxDeratingDischargeCurrent;
+        r.temperature_rating = temperature;
+        return r;
+    }
+
+    CurveState states_[kNumCurves];
+    bool initialized_ = false;
+    std::size_t reclassifications_ = 0;
+    std::size_t cell_passes_ = 0;
+};
+
+/**
+ * @brief Cell voltages and sensor temperatures synthesised for replaying module traces
+ *
+ * Traces only carry the module voltage u, so cell c is placed at u + spread * (rank - 0.5) with
+ * rank = (7c mod N) / (N - 1): the lowest and highest cell are not always cells 0 and N - 1.
+ * Sensor s of sample k of n reads t_lo + (t_hi - t_lo) * k / (n - 1) + 0.5 s [degC].
+ * derating_replay and stabl_bench both use this, so their numbers stay comparable.
+ */
+template <typename Traits>
+struct SyntheticLimitInputs {
+    static constexpr std::size_t kNumCells = Traits::kNumCells * Traits::kNumParallelBat;
+    static constexpr std::size_t kNumTempSensors = Traits::kNumTempSensors;
+
+    double spread = 0.03;       /**< Spread of the cell voltages [V] */
+    double t_lo = 25.0;         /**< Temperature at the first sample [degC] */
+    double t_hi = 25.0;         /**< Temperature at the last sample [degC] */
+
+    /** Offsets of the kNumCells cells from u [V], as CurrentLimitEngine's trace batch update takes them */
+    void cell_offsets(double* offsets) const
+    {
+        for (std::size_t c = 0; c < kNumCells; ++c) {
+            const double rank = kNumCells > 1 ? static_cast<double>((c * 7) % kNumCells) / (kNumCells - 1) : 0.5;
+            offsets[c] = spread * (rank - 0.5);
+        }
+    }
+
+    /**
+     * @brief Sensor rows of samples [@p first, @p first + @p rows) of a trace of @p samples
+     *
+     * Returns the row stride for @p temperatures. Without a ramp that is 0 and only one row is
+     * written; otherwise @p rows rows of kNumTempSensors values.
+     */
+    std::size_t temperatures(std::size_t first, std::size_t rows, std::size_t samples, float* temperatures) const
+    {
+        const std::size_t stride = t_lo == t_hi ? 0 : kNumTempSensors;
+        const std::size_t written = stride == 0 ? 1 : rows;
+        for (std::size_t k = 0; k < written; ++k) {
+            const double f =
+                samples > 1 ? static_cast<double>(first + k) / static_cast<double>(samples - 1) : 0.0;
+            for (std::size_t s = 0; s < kNumTempSensors; ++s)
+                temperatures[k * kNumTempSensors + s] = static_cast<float>(t_lo + (t_hi - t_lo) * f + 0.5 * s);
+        }
+        return stride;
+    }
+};
+
+/**
+ * @brief From-scratch evaluation of the same limits, one linear search per cell and curve
+ *
+ * The straightforward implementation the engine replaces; kept for validation and comparison.
+ */
+template <typename Traits>
+CurrentLimits current_limits_reference(const float* cell_voltages, const float* temperatures)
+{
+    const auto interpolate = [](const float* x, const float* y, std::size_t n, float v) {
+        if (v <= x[0])
+            return y[0];
+        for (std::size_t k = 1; k < n; ++k) {
+            if (v < x[k])
+                return y[k - 1] + (y[k] - y[k - 1]) * (v - x[k - 1]) / (x[k] - x[k - 1]);
+        }
+        return y[n - 1];
+    };
+    const float der_charge_v[2] = {Traits::kChargeDeratingOne, Traits::kChargeDeratingZero};
+    const float der_charge_i[2] = {Traits::kMaxDeratingChargeCurrent, 0.0f};
+    const float der_discharge_v[2] = {Traits::kDischargeDeratingZero, Traits::kDischargeDeratingOne};
+    const float der_discharge_i[2] = {0.0f, Traits::kMaxDeratingDischargeCurrent};
+
+    float charge = -3.0e38f, charge_derating = -3.0e38f;
+    float discharge = 3.0e38f, discharge_derating = 3.0e38f;
+    for (std::size_t i = 0; i < Traits::kNumCells * Traits::kNumParallelBat; ++i) {
+        const float v = cell_voltages[i];
+        const float c = interpolate(Traits::charge_limit_v, Traits::charge_limit_i, Traits::kChargeLimitPoints, v);
+        const float cd = interpolate(der_charge_v, der_charge_i, 2, v);
+        const float d =
+            interpolate(Traits::discharge_limit_v, Traits::discharge_limit_i, Traits::kDischargeLimitPoints, v);
+        const float dd = interpolate(der_discharge_v, der_discharge_i, 2, v);
+        charge = c > charge ? c : charge;
+        charge_derating = cd > charge_derating ? cd : charge_derating;
+        discharge = d < discharge ? d : discharge;
+        discharge_derating = dd < discharge_derating ? dd : discharge_derating;
+    }
+    float temperature = 1.0f;
+    for (std::size_t i = 0; i < Traits::kNumTempSensors; ++i) {
+        if (temperatures[i] < Traits::kTempMin || temperatures[i] > Traits::kTempMax)
+            temperature = 0.0f;
+    }
+    const float scale = static_cast<float>(Traits::kNumParallelBat);
+    CurrentLimits r;
+    r.charge = (charge > charge_derating ? charge : charge_derating) * temperature * scale + 0.0f;
+    r.discharge = (discharge < discharge_derating ? discharge : discharge_derating) * temperature * scale;
+    r.charge_rating = charge_derating / Traits::kMaxDeratingChargeCurrent + 0.0f;
+    r.discharge_rating = discharge_derating / Traits::kMaxDeratingDischargeCurrent;
+    r.temperature_rating = temperature;
+    return r;
+}
+
+} // namespace stabl
+
+#endif /* STABL_CURRENT_LIMITS_H */
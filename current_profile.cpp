@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        current_profile.cpp
+ * @brief       Piecewise-constant current profiles for the native simulators
+ */
+#include "current_profile.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace stabl {
+
+namespace {
+
+constexpr double kRestTime = 20.0 * 60.0;   /**< 20 minutes rest after each step */
+constexpr double kRelaxTime = 60.0 * 60.0;  /**< 1 hour final relaxation */
+constexpr double kPwmOn = 20.0;             /**< PWM ON time [s] */
+constexpr double kPwmOff = 10.0;            /**< PWM OFF time [s] */
+
+double default_current(const EcmParameters& params, double discharge_current)
+{
+    return discharge_current > 0.0 ? discharge_current : params.capacity_ah * params.c_rate;
+}
+
+} // namespace
+
+CurrentProfile generate_step_discharge_profile(const EcmParameters& params, double discharge_current,
+                                               double soc_start, double soc_end, double soc_step)
+{
+    discharge_current = default_current(params, discharge_current);
+    const double step_charge = soc_step * params.capacity_ah * 3600.0;
+    const double t_discharge = step_charge / discharge_current;
+
+    CurrentProfile profile;
+    double t = 0.0;
+    double soc = soc_start;
+    while (soc - soc_step >= soc_end - 1e-4) {
+        profile.push_back({t, discharge_current});
+        const double t_end = t + t_discharge;
+        profile.push_back({t_end, 0.0});
+        t = t_end + kRestTime;
+        soc -= soc_step;
+    }
+    profile.push_back({t + kRelaxTime, 0.0});
+    return profile;
+}
+
+CurrentProfile generate_step_discharge_profile_pwm(const EcmParameters& params, double discharge_current,
+                                                   double soc_start, double soc_end, double soc_step)
+{
+    discharge_current = default_current(params, discharge_current);
+    const double step_charge = soc_step * params.capacity_ah * 3600.0;
+
+    CurrentProfile profile;
+    double t = 0.0;
+    double soc = soc_start;
+    while (soc - soc_step >= soc_end - 1e-4) {
+        double charge_removed = 0.0;
+        while (charge_removed < step_charge) {
+            profile.push_back({t, discharge_current});
+            const double t_on_end = t + kPwmOn;
+            charge_removed += discharge_current * kPwmOn;
+            profile.push_back({t_on_end, 0.0});
+            t = t_on_end + kPwmOff;
+        }
+        profile.push_back({t, 0.0});
+        t += kRestTime;
+        soc -= soc_step;
+    }
+    profile.push_back({t + kRelaxTime, 0.0});
+    return profile;
+}
+
+CurrentProfile resample_current_profile(const CurrentProfile& profile, double sampling_rate)
+{
+    CurrentProfile out;
+    if (profile.empty() || !(sampling_rate > 0.0))
+        return out;
+
+    const double t_min = profile.front().time;
+    const double t_max = profile.back().time;
+    std::size_t i = 0;
+    for (std::size_t k = 0;; ++k) {
+        const double t = t_min + static_cast<double>(k) * sampling_rate;
+        if (t >= t_max + sampling_rate)
+            break;
+        while (i + 1 < profile.size() && profile[i + 1].time <= t)
+            ++i;
+        out.push_back({t, profile[i].current});
+    }
+    return out;
+}
+
+CurrentProfile load_current_profile(const std::string& csv_path)
+{
+    std::ifstream in(csv_path);
+    if (!in)
+        throw std::runtime_error("cannot open current profile '" + csv_path + "'");
+
+    CurrentProfile profile;
+    std::string line;
+    bool first = true;
+    while (std::getline(in, line)) {
+        if (line.empty() || line == "\r")
+            continue;
+        const char* begin = line.c_str();
+        char* end = nullptr;
+        const double t = std::strtod(begin, &end);
+        const bool numeric = end != begin && *end == ',';
+        if (!numeric) {
+            if (first) {
+                first = false;
+                continue;
+            }
+            throw std::runtime_error("malformed current profile row: " + line);
+        }
+        first = false;
+        const char* field = end + 1;
+        const double i = std::strtod(field, &end);
+        while (*end == ' ' || *end == '\r')
+            ++end;
+        if (end == field || (*end != '\0' && *end != ','))
+            throw std::runtime_error("malformed current profile row: " + line);
+        profile.push_back({t, i});
+    }
+    return profile;
+}
+
+} // namespace stabl
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        current_profile.h
+ * @brief       Piecewise-constant current profiles for the native simulators
+ *
+ * Ports of the profile generators in new_workflow*.ipynb. A profile is a list of breakpoints;
+ * the current of a breakpoint holds until the next one and the last breakpoint marks the end.
+ */
+#ifndef STABL_CURRENT_PROFILE_H
+#define STABL_CURRENT_PROFILE_H
+
+#include <string>
+
+#include "ecm_simulator.h"
+
+namespace stabl {
+
+/**
+ * @brief Discharge in @p soc_step steps with 20 min rest after each step and 1 h final relaxation
+ *
+ * Same as generate_step_discharge_profile(). A @p discharge_current <= 0 selects
+ * capacity_Ah * c_rate from @p params.
+ */
+CurrentProfile generate_step_discharge_profile(const EcmParameters& params, double discharge_current = 0.0,
+                                               double soc_start = 0.9, double soc_end = 0.1,
+                                               double soc_step = 0.1);
+
+/**
+ * @brief Like generate_step_discharge_profile(), but each step is a 20 s ON / 10 s OFF pulse train
+ *
+ * Same as generate_step_discharge_profile_pwm().
+ */
+CurrentProfile generate_step_discharge_profile_pwm(const EcmParameters& params, double discharge_current = 0.0,
+                                                   double soc_start = 0.9, double soc_end = 0.1,
+                                                   double soc_step = 0.1);
+
+/**
+ * @brief Resample to a regular grid holding the previous value
+ *
+ * Same as resample_current_profile() in the notebooks. Only needed to reproduce their results
+ * bit for bit; the simulator itself does not need a regular grid.
+ */
+CurrentProfile resample_current_profile(const CurrentProfile& profile, double sampling_rate = 1.0);
+
+/** Read "time,current" rows; a non-numeric first line is treated as a header. */
+CurrentProfile load_current_profile(const std::string& csv_path);
+
+} // namespace stabl
+
+#endif /* STABL_CURRENT_PROFILE_H */
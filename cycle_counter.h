@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        cycle_counter.h
+ * @brief       Pluggable cycle counters and fixed-size latency statistics
+ *
+ * A counter is a type with
+ *
+ *   Value             unsigned tick type; differences are taken modulo its range
+ *   kEnabled          false compiles the instrumentation out
+ *   static Value now()
+ *
+ * TscCycleCounter reads the x86 time stamp counter on the host, DwtCycleCounter the Cortex-M
+ * DWT cycle counter on target (call DwtCycleCounter::enable() once at start-up).
+ * DefaultCycleCounter picks whichever fits the build and falls back to std::chrono::steady_clock
+ * (nanoseconds) on other hosts.
+ */
+#ifndef STABL_CYCLE_COUNTER_H
+#define STABL_CYCLE_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STABL_HAVE_TSC 1
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define STABL_HAVE_DWT 1
+#else
+#include <chrono>
+#endif
+
+namespace stabl {
+
+/** No instrumentation. */
+struct NullCycleCounter {
+    using Value = std::uint32_t;
+    static constexpr bool kEnabled = false;
+    static Value now() { return 0; }
+};
+
+#ifdef STABL_HAVE_TSC
+/** x86 time stamp counter, fenced so that earlier instructions retire before it is read. */
+struct TscCycleCounter {
+    using Value = std::uint64_t;
+    static constexpr bool kEnabled = true;
+    static Value now()
+    {
+        _mm_lfence();
+        const Value t = __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+};
+using DefaultCycleCounter = TscCycleCounter;
+#elif defined(STABL_HAVE_DWT)
+/** Cortex-M DWT_CYCCNT; wraps every 2^32 cycles, which the unsigned difference handles. */
+struct DwtCycleCounter {
+    using Value = std::uint32_t;
+    static constexpr bool kEnabled = true;
+
+    static void enable()
+    {
+        demcr() |= 1u << 24;    /* TRCENA */
+        cyccnt() = 0;
+        ctrl() |= 1u;           /* CYCCNTENA */
+    }
+    static Value now() { return cyccnt(); }
+
+private:
+    static volatile std::uint32_t& demcr() { return *reinterpret_cast<volatile std::uint32_t*>(0xE000EDFCu); }
+    static volatile std::uint32_t& ctrl() { return *reinterpret_cast<volatile std::uint32_t*>(0xE0001000u); }
+    static volatile std::uint32_t& cyccnt() { return *reinterpret_cast<volatile std::uint32_t*>(0xE0001004u); }
+};
+using DefaultCycleCounter = DwtCycleCounter;
+#else
+/** Host fallback without a cycle counter: nanoseconds of the steady clock. */
+struct SteadyClockCounter {
+    using Value = std::uint64_t;
+    static constexpr bool kEnabled = true;
+    static Value now()
+    {
+        return static_cast<Value>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch())
+                                      .count());
+    }
+};
+using DefaultCycleCounter = SteadyClockCounter;
+#endif
+
+/** Min/max/mean and a power-of-two histogram of per-call tick counts; no allocation. */
+class CycleStats {
+public:
+    static constexpr std::size_t kBins = 40;    /**< Bin b holds counts in [2^b, 2^(b+1)), bin 0 also 0 */
+
+    void record(std::uint64_t ticks)
+    {
+        if (count_ == 0 || ticks < min_)
+            min_ = ticks;
+        if (ticks > max_)
+            max_ = ticks;
+        total_ += ticks;
+        ++count_;
+        std::size_t b = 0;
+        while (b + 1 < kBins && (ticks >> (b + 1)) != 0)
+            ++b;
+        ++histogram_[b];
+    }
+
+    void merge(const CycleStats& other)
+    {
+        if (other.count_ == 0)
+            return;
+        if (count_ == 0 || other.min_ < min_)
+            min_ = other.min_;
+        if (other.max_ > max_)
+            max_ = other.max_;
+        total_ += other.total_;
+        count_ += other.count_;
+        for (std::size_t b = 0; b < kBins; ++b)
+            histogram_[b] += other.histogram_[b];
+    }
+
+    void reset() { *this = CycleStats(); }
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t min() const { return min_; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(total_) / static_cast<double>(count_) : 0.0; }
+    std::uint64_t bin(std::size_t b) const { return histogram_[b]; }
+
+    /** Upper edge of the bin containing quantile @p q in [0, 1], never above max(). */
+    std::uint64_t quantile_bound(double q) const
+    {
+        const double target = q * static_cast<double>(count_);
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kBins; ++b) {
+            seen += histogram_[b];
+            if (static_cast<double>(seen) >= target && seen > 0) {
+                const std::uint64_t edge = (std::uint64_t{2} << b) - 1;
+                return edge < max_ ? edge : max_;
+            }
+        }
+        return max_;
+    }
+
+private:
+    std::uint64_t min_ = 0;
+    std::uint64_t max_ = 0;
+    std::uint64_t total_ = 0;
+    std::uint64_t count_ = 0;
+    std::uint64_t histogram_[kBins] = {};
+};
+
+} // namespace stabl
+
+#endif /* STABL_CYCLE_COUNTER_H */
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        derating_replay.cpp
+ * @brief       Offline replay of module traces through the current limit engine
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread -mavx2 -mfma derating_replay.cpp module_trace.cpp trace_file.cpp \
+ *             -o derating_replay
+ *
+ * Usage:  derating_replay <trace> [options]
+ *   the trace is CSV (input_data.csv layout) or a binary trace from trace_convert
+ *   --cell-trace            the trace holds one cell (as input_data.csv): u_bat is the cell voltage
+ *   --spread <V>            spread the cells evenly over +-spread/2 around u_bat / cells (default: 0.03)
+ *   --temperature lo[:hi]   sensor temperature, ramped linearly over the trace if hi is given
+ *                           (default: 25)
+ *   --threads <n>           replay chunks of the trace in parallel (default: 1)
+ *   --no-reference          skip the from-scratch evaluation used for checking and comparison
+ *   -o <out.csv>            write time and the CurrentLimits fields per sample
+ *
+ * The trace is streamed chunk by chunk into the engine, a binary trace straight from the
+ * mapping. The traces only carry the module voltage, so the cell voltages are synthesised from
+ * it. The result is identical for any thread count, because the cached segments only decide
+ * how a limit is computed, not its value.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "battery_traits.h"
+#include "current_limits.h"
+#include "thread_pool.h"
+#include "trace_file.h"
+
+namespace {
+
+using Traits = stabl::LgE60Traits;
+using Engine = stabl::CurrentLimitEngine<Traits>;
+
+void usage()
+{
+    std::fprintf(stderr, "usage: derating_replay <trace> [--cell-trace] [--spread V] [--temperature lo[:hi]]\n"
+                         "                       [--threads n] [--no-reference] [-o out.csv]\n");
+}
+
+template <typename F>
+double timed(F&& fn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string trace_path;
+    std::string out_path;
+    bool cell_trace = false;
+    bool reference = true;
+    stabl::SyntheticLimitInputs<Traits> synthetic;
+    std::size_t threads = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--cell-trace")) {
+            cell_trace = true;
+        } else if (!std::strcmp(argv[i], "--spread") && has_value) {
+            synthetic.spread = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--temperature") && has_value) {
+            const int n = std::sscanf(argv[++i], "%lf:%lf", &synthetic.t_lo, &synthetic.t_hi);
+            if (n == 1)
+                synthetic.t_hi = synthetic.t_lo;
+            else if (n != 2) {
+                usage();
+                return 2;
+            }
+        } else if (!std::strcmp(argv[i], "--threads") && has_value) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--no-reference")) {
+            reference = false;
+        } else if (!std::strcmp(argv[i], "-o") && has_value) {
+            out_path = argv[++i];
+        } else if (argv[i][0] != '-' && trace_path.empty()) {
+            trace_path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (trace_path.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        const stabl::ModuleTraceSource trace(trace_path);
+        const std::size_t n = trace.size();
+        constexpr std::size_t kCells = Engine::kNumCells;
+        constexpr std::size_t kSensors = Engine::kNumTempSensors;
+
+        std::vector<double> offsets(kCells);
+        synthetic.cell_offsets(offsets.data());
+        const double cell_scale = cell_trace ? 1.0 : 1.0 / static_cast<double>(Traits::kNumCells);
+
+        /* Sensor rows of samples [first, first + rows), in scratch */
+        const auto temperature_rows = [&](std::size_t first, std::size_t rows, std::vector<float>& scratch,
+                                          std::size_t& stride) -> const float* {
+            scratch.resize(rows * kSensors);
+            stride = synthetic.temperatures(first, rows, n, scratch.data());
+            return scratch.data();
+        };
+
+        std::vector<stabl::CurrentLimits> limits(n);
+        stabl::ThreadPool pool(threads);
+        std::size_t reclassifications = 0, cell_passes = 0;
+        std::vector<std::size_t> chunk_reclass(pool.size()), chunk_passes(pool.size());
+        const double engine_s = timed([&] {
+            pool.parallel_for(pool.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t part = begin; part < end; ++part) {
+                    Engine engine;
+                    std::vector<float> temperatures;
+                    const auto replay = [&](std::size_t first, const stabl::ModuleTraceView& rows) {
+                        std::size_t stride;
+                        const float* t = temperature_rows(first, rows.size(), temperatures, stride);
+                        engine.update(rows.u_bat, cell_scale, offsets.data(), t, stride, rows.size(),
+                                      limits.data() + first);
+                    };
+                    trace.for_each_range(n * part / pool.size(), n * (part + 1) / pool.size(), replay);
+                    chunk_reclass[part] = engine.reclassifications();
+                    chunk_passes[part] = engine.cell_passes();
+                }
+            });
+        });
+        for (std::size_t part = 0; part < pool.size(); ++part) {
+            reclassifications += chunk_reclass[part];
+            cell_passes += chunk_passes[part];
+        }
+        std::printf("%zu samples x %zu cells (%s), spread %.3f V, %zu threads\n", n, kCells, stabl::simd::Native::kName,
+                    synthetic.spread, pool.size());
+        std::printf("engine     %10.3f ms  %8.1f ns/sample  breakpoint crossings %zu, per-cell passes %zu\n",
+                    engine_s * 1e3, engine_s * 1e9 / static_cast<double>(n), reclassifications, cell_passes);
+
+        if (reference) {
+            std::vector<stabl::CurrentLimits> expected(n);
+            std::vector<float> temperatures;
+            const double reference_s = timed([&] {
+                trace.for_each_range(0, n, [&](std::size_t first, const stabl::ModuleTraceView& rows) {
+                    std::size_t stride;
+                    const float* t = temperature_rows(first, rows.size(), temperatures, stride);
+                    float cells[kCells];
+                    for (std::size_t k = 0; k < rows.size(); ++k) {
+                        for (std::size_t c = 0; c < kCells; ++c)
+                            cells[c] = static_cast<float>(rows.u_bat[k] * cell_scale + offsets[c]);
+                        expected[first + k] = stabl::current_limits_reference<Traits>(cells, t + k * stride);
+                    }
+                });
+            });
+            double max_diff = 0.0;
+            double fields[stabl::CurrentLimits::kSize], reference_fields[stabl::CurrentLimits::kSize];
+            for (std::size_t k = 0; k < n; ++k) {
+                limits[k].store(fields);
+                expected[k].store(reference_fields);
+                for (std::size_t j = 0; j < stabl::CurrentLimits::kSize; ++j)
+                    max_diff = std::max(max_diff, std::fabs(fields[j] - reference_fields[j]));
+            }
+            std::printf("reference  %10.3f ms  %8.1f ns/sample  max difference %.3g\n", reference_s * 1e3,
+                        reference_s * 1e9 / static_cast<double>(n), max_diff);
+        }
+
+        if (!out_path.empty()) {
+            FILE* out = std::fopen(out_path.c_str(), "w");
+            if (out == nullptr)
+                throw std::runtime_error("cannot write " + out_path);
+            std::fputs("time", out);
+            for (const char* name : stabl::CurrentLimits::kNames)
+                std::fprintf(out, ",%s", name);
+            std::fputc('\n', out);
+            double fields[stabl::CurrentLimits::kSize];
+            trace.for_each_range(0, n, [&](std::size_t first, const stabl::ModuleTraceView& rows) {
+                for (std::size_t k = 0; k < rows.size(); ++k) {
+                    limits[first + k].store(fields);
+                    std::fprintf(out, "%.17g,%.6g,%.6g,%.6g,%.6g,%.6g\n", rows.time[k], fields[0], fields[1],
+                                 fields[2], fields[3], fields[4]);
+                }
+            });
+            std::fclose(out);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "derating_replay: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        ecm_fit.cpp
+ * @brief       Fit R0/R1/C1/R2/C2 of a battery config to measured traces
+ *
+ * Build:  g++ -O3 -march=native -std=c++17 -pthread ecm_fit.cpp parameter_fit.cpp ecm_simulator.cpp \
+ *             module_trace.cpp trace_file.cpp -o ecm_fit
+ *
+ * Usage:  ecm_fit <battery.config> <trace>... [options]
+ *   traces are CSV (input_data.csv layout) or binary traces from trace_convert; the config
+ *   supplies OCV curve and capacity and must match the trace (cell or module)
+ *   --threads <n>      worker threads (default: hardware concurrency)
+ *   --soc0 <x>         known initial SOC of all traces (default: fitted)
+ *   --one-rc           fit a single RC branch, R2 = 0
+ *   --tau-min <s>      smallest RC time constant searched (default: 1)
+ *   --tau-max <s>      largest RC time constant searched (default: 20000)
+ *   -o <file>          fitted config of a single trace (default: stdout summary only)
+ *   --out-dir <dir>    write <dir>/<trace name>.config for every trace
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "ecm_simulator.h"
+#include "parameter_fit.h"
+#include "trace_file.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr, "usage: ecm_fit <battery.config> <trace>... [--threads n] [--soc0 x] [--one-rc]\n"
+                         "               [--tau-min s] [--tau-max s] [-o out.config | --out-dir dir]\n");
+}
+
+std::string stem(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const auto dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+
+    const std::string config_path = argv[1];
+    std::vector<std::string> trace_paths;
+    stabl::FitOptions options;
+    std::size_t threads = 0;
+    std::string out_path;
+    std::string out_dir;
+    for (int i = 2; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--threads") && has_value) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--soc0") && has_value) {
+            options.soc0 = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--one-rc")) {
+            options.rc_branches = 1;
+        } else if (!std::strcmp(argv[i], "--tau-min") && has_value) {
+            options.tau_min = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--tau-max") && has_value) {
+            options.tau_max = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-o") && has_value) {
+            out_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--out-dir") && has_value) {
+            out_dir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            trace_paths.emplace_back(argv[i]);
+        }
+    }
+    if (trace_paths.empty() || (!out_path.empty() && trace_paths.size() != 1)) {
+        usage();
+        return 2;
+    }
+
+    try {
+        const stabl::EcmParameters base = stabl::load_ecm_parameters(config_path);
+        std::vector<stabl::ModuleTraceSource> traces;
+        for (const auto& path : trace_paths)
+            traces.emplace_back(path);
+
+        stabl::ParameterFitter fitter(base, options, threads);
+        const auto t_start = std::chrono::steady_clock::now();
+        const std::vector<stabl::FitResult> results = fitter.fit_all(traces);
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+        std::size_t evaluations = 0;
+        double samples = 0.0;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const stabl::FitResult& r = results[i];
+            evaluations += r.evaluations;
+            samples += static_cast<double>(r.evaluations) * static_cast<double>(traces[i].size());
+            std::printf("%s: R0 = %.6g, R1 = %.6g, C1 = %.6g, R2 = %.6g, C2 = %.6g, soc0 = %.4f, "
+                        "rms = %.3f mV, max = %.3f mV\n",
+                        trace_paths[i].c_str(), r.params.r0, r.params.r1, r.params.c1, r.params.r2, r.params.c2,
+                        r.soc0, r.rms_error * 1e3, r.max_error * 1e3);
+            if (!out_path.empty())
+                stabl::save_ecm_parameters(config_path, out_path, r.params);
+            if (!out_dir.empty())
+                stabl::save_ecm_parameters(config_path, out_dir + "/" + stem(trace_paths[i]) + ".config", r.params);
+        }
+        std::printf("%zu traces, %zu candidates in %.3f s on %zu threads: %.0f model steps/s\n", results.size(),
+                    evaluations, wall, fitter.num_threads(), samples / wall);
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "ecm_fit: %s\n", e.what());
+        return 1;
+    }
+}
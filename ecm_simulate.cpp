@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        ecm_simulate.cpp
+ * @brief       Command line front end of the equivalent-circuit simulator
+ *
+ * Build:  g++ -O2 -std=c++17 ecm_simulate.cpp ecm_simulator.cpp current_profile.cpp -o ecm_simulate
+ *
+ * Usage:  ecm_simulate <battery.config> [options]
+ *   --profile step|pwm|<file.csv>  current profile (default: step)
+ *   --soc0 <x>                     initial SOC (default: 0.9)
+ *   --sample-period <s>            output period (default: sampling_rate of the config)
+ *   --resample                     hold the profile on a 1 s grid first, as the notebooks do
+ *   --fmu-input                    write time,i_mod_avg,i_mod_rms,u_bat (input_data.csv layout)
+ *   -o <file.csv>                  output file (default: stdout)
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "current_profile.h"
+#include "ecm_simulator.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: ecm_simulate <battery.config> [--profile step|pwm|<file.csv>] [--soc0 x]\n"
+                 "                    [--sample-period s] [--resample] [--fmu-input] [-o out.csv]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+
+    std::string config_path = argv[1];
+    std::string profile_name = "step";
+    std::string out_path;
+    double soc0 = 0.9;
+    double sample_period = 0.0;
+    bool resample = false;
+    bool fmu_input = false;
+
+    for (int i = 2; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--profile") && has_value) {
+            profile_name = argv[++i];
+        } else if (!std::strcmp(argv[i], "--soc0") && has_value) {
+            soc0 = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--sample-period") && has_value) {
+            sample_period = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--resample")) {
+            resample = true;
+        } else if (!std::strcmp(argv[i], "--fmu-input")) {
+            fmu_input = true;
+        } else if (!std::strcmp(argv[i], "-o") && has_value) {
+            out_path = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    try {
+        const stabl::EcmParameters params = stabl::load_ecm_parameters(config_path);
+        if (!(sample_period > 0.0))
+            sample_period = params.sampling_rate;
+
+        stabl::CurrentProfile profile;
+        if (profile_name == "step")
+            profile = stabl::generate_step_discharge_profile(params);
+        else if (profile_name == "pwm")
+            profile = stabl::generate_step_discharge_profile_pwm(params);
+        else
+            profile = stabl::load_current_profile(profile_name);
+        if (resample)
+            profile = stabl::resample_current_profile(profile, 1.0);
+
+        FILE* out = out_path.empty() ? stdout : std::fopen(out_path.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open '%s'\n", out_path.c_str());
+            return 1;
+        }
+
+        std::fputs(fmu_input ? "time,i_mod_avg,i_mod_rms,u_bat\n" : "time,current,voltage,soc,ocv\n", out);
+        stabl::EcmSimulator sim(params, soc0);
+        sim.run(profile, sample_period, [&](const stabl::EcmSample& s) {
+            if (fmu_input)
+                std::fprintf(out, "%.17g,%.17g,%.17g,%.17g\n", s.time, s.current, s.current, s.voltage);
+            else
+                std::fprintf(out, "%.17g,%.17g,%.17g,%.17g,%.17g\n", s.time, s.current, s.voltage, s.soc, s.ocv);
+        });
+
+        if (out != stdout ? std::fclose(out) != 0 : std::fflush(out) != 0)
+            throw std::runtime_error("cannot write '" + (out_path.empty() ? std::string("stdout") : out_path) + "'");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "ecm_simulate: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
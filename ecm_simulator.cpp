@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        ecm_simulator.cpp
+ * @brief       Battery config parsing and OCV spline for the equivalent-circuit simulator
+ */
+#include "ecm_simulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace stabl {
+
+namespace {
+
+using IniSection = std::map<std::string, std::string>;
+using IniFile = std::map<std::string, IniSection>;
+
+std::string trim(const std::string& s)
+{
+    const auto first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+        return std::string();
+    const auto last = s.find_last_not_of(" \t\r\n");
+    return s.substr(first, last - first + 1);
+}
+
+/* Subset of Python's configparser: [section], key = value, ';'/'#' full-line comments */
+IniFile read_ini(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open battery config '" + path + "'");
+
+    IniFile ini;
+    IniSection* section = nullptr;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#')
+            continue;
+        if (line.front() == '[' && line.back() == ']') {
+            section = &ini[trim(line.substr(1, line.size() - 2))];
+            continue;
+        }
+        const auto sep = line.find_first_of("=:");
+        if (section == nullptr || sep == std::string::npos)
+            throw std::runtime_error("malformed line in '" + path + "': " + line);
+        (*section)[trim(line.substr(0, sep))] = trim(line.substr(sep + 1));
+    }
+    return ini;
+}
+
+const std::string& lookup(const IniFile& ini, const std::string& section, const std::string& key)
+{
+    const auto s = ini.find(section);
+    if (s != ini.end()) {
+        const auto k = s->second.find(key);
+        if (k != s->second.end())
+            return k->second;
+    }
+    throw std::runtime_error("battery config is missing [" + section + "] " + key);
+}
+
+double to_double(const std::string& value)
+{
+    std::size_t used = 0;
+    const double v = std::stod(value, &used);
+    if (trim(value.substr(used)).size() != 0)
+        throw std::runtime_error("not a number: '" + value + "'");
+    return v;
+}
+
+double lookup_double(const IniFile& ini, const std::string& section, const std::string& key)
+{
+    return to_double(lookup(ini, section, key));
+}
+
+double lookup_double(const IniFile& ini, const std::string& section, const std::string& key,
+                     double fallback)
+{
+    const auto s = ini.find(section);
+    if (s == ini.end() || s->second.find(key) == s->second.end())
+        return fallback;
+    return to_double(s->second.at(key));
+}
+
+std::vector<double> lookup_list(const IniFile& ini, const std::string& section, const std::string& key)
+{
+    std::vector<double> values;
+    std::stringstream ss(lookup(ini, section, key));
+    std::string item;
+    while (std::getline(ss, item, ','))
+        values.push_back(to_double(trim(item)));
+    return values;
+}
+
+/* Dense Gaussian elimination with partial pivoting; the systems here are ~15x15 */
+std::vector<double> solve_dense(std::vector<std::vector<double>> a, std::vector<double> rhs)
+{
+    const std::size_t n = rhs.size();
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < n; ++row)
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col]))
+                pivot = row;
+        std::swap(a[col], a[pivot]);
+        std::swap(rhs[col], rhs[pivot]);
+        if (a[col][col] == 0.0)
+            throw std::runtime_error("singular OCV spline system");
+        for (std::size_t row = col + 1; row < n; ++row) {
+            const double f = a[row][col] / a[col][col];
+            for (std::size_t j = col; j < n; ++j)
+                a[row][j] -= f * a[col][j];
+            rhs[row] -= f * rhs[col];
+        }
+    }
+    std::vector<double> x(n);
+    for (std::size_t row = n; row-- > 0;) {
+        double acc = rhs[row];
+        for (std::size_t j = row + 1; j < n; ++j)
+            acc -= a[row][j] * x[j];
+        x[row] = acc / a[row][row];
+    }
+    return x;
+}
+
+} // namespace
+
+OcvCurve::OcvCurve(std::vector<double> soc, std::vector<double> ocv)
+{
+    if (soc.size() != ocv.size() || soc.size() < 4)
+        throw std::runtime_error("OCV curve needs >= 4 matching soc/ocv points");
+
+    /* Sort by SOC; configs list 100 -> 0 */
+    std::vector<std::size_t> order(soc.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return soc[a] < soc[b]; });
+    for (std::size_t i : order) {
+        x_.push_back(soc[i]);
+        y_.push_back(ocv[i]);
+    }
+
+    const std::size_t n = x_.size();
+    std::vector<double> h(n - 1);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        h[i] = x_[i + 1] - x_[i];
+        if (!(h[i] > 0.0))
+            throw std::runtime_error("OCV curve SOC points must be distinct");
+    }
+
+    /* Second derivatives M with not-a-knot end conditions (continuous third derivative at
+     * the second and second-to-last knot), as scipy's make_interp_spline(k=3) */
+    std::vector<std::vector<double>> a(n, std::vector<double>(n, 0.0));
+    std::vector<double> rhs(n, 0.0);
+    a[0][0] = -h[1];
+    a[0][1] = h[0] + h[1];
+    a[0][2] = -h[0];
+    for (std::size_t i = 1; i + 1 < n; ++i) {
+        a[i][i - 1] = h[i - 1];
+        a[i][i] = 2.0 * (h[i - 1] + h[i]);
+        a[i][i + 1] = h[i];
+        rhs[i] = 6.0 * ((y_[i + 1] - y_[i]) / h[i] - (y_[i] - y_[i - 1]) / h[i - 1]);
+    }
+    a[n - 1][n - 3] = -h[n - 2];
+    a[n - 1][n - 2] = h[n - 3] + h[n - 2];
+    a[n - 1][n - 1] = -h[n - 3];
+    const std::vector<double> m = solve_dense(std::move(a), std::move(rhs));
+
+    b_.resize(n - 1);
+    c_.resize(n - 1);
+    d_.resize(n - 1);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        b_[i] = (y_[i + 1] - y_[i]) / h[i] - h[i] * (2.0 * m[i] + m[i + 1]) / 6.0;
+        c_[i] = m[i] / 2.0;
+        d_[i] = (m[i + 1] - m[i]) / (6.0 * h[i]);
+    }
+}
+
+double OcvCurve::operator()(double soc) const
+{
+    if (x_.empty())
+        return 0.0;
+    /* Segment whose left knot is <= soc; outer segments extrapolate */
+    const auto it = std::upper_bound(x_.begin() + 1, x_.end() - 1, soc);
+    const std::size_t i = static_cast<std::size_t>(it - x_.begin()) - 1;
+    const double t = soc - x_[i];
+    return y_[i] + t * (b_[i] + t * (c_[i] + t * d_[i]));
+}
+
+double OcvCurve::derivative(double soc) const
+{
+    if (x_.empty())
+        return 0.0;
+    const auto it = std::upper_bound(x_.begin() + 1, x_.end() - 1, soc);
+    const std::size_t i = static_cast<std::size_t>(it - x_.begin()) - 1;
+    const double t = soc - x_[i];
+    return b_[i] + t * (2.0 * c_[i] + t * 3.0 * d_[i]);
+}
+
+EcmParameters load_ecm_parameters(const std::string& config_path)
+{
+    const IniFile ini = read_ini(config_path);
+
+    EcmParameters p;
+    p.r0 = lookup_double(ini, "battery", "R0");
+    p.r1 = lookup_double(ini, "battery", "R1");
+    p.c1 = lookup_double(ini, "battery", "C1");
+    p.r2 = lookup_double(ini, "battery", "R2", 0.0);
+    p.c2 = lookup_double(ini, "battery", "C2", 1.0);
+    p.capacity_ah = lookup_double(ini, "battery", "capacity_Ah");
+    p.sampling_rate = lookup_double(ini, "battery", "sampling_rate", 1.0);
+    p.c_rate = lookup_double(ini, "battery", "c_rate", 1.0);
+
+    std::vector<double> soc = lookup_list(ini, "soc_ocv", "soc");
+    for (double& s : soc)
+        s /= 100.0;
+    p.ocv = OcvCurve(std::move(soc), lookup_list(ini, "soc_ocv", "ocv"));
+    return p;
+}
+
+void save_ecm_parameters(const std::string& template_path, const std::string& config_path,
+                         const EcmParameters& params)
+{
+    std::ifstream in(template_path);
+    if (!in)
+        throw std::runtime_error("cannot open battery config '" + template_path + "'");
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+
+    const std::pair<const char*, double> values[] = {
+        {"R0", params.r0}, {"R1", params.r1}, {"C1", params.c1}, {"R2", params.r2}, {"C2", params.c2}};
+    auto format = [](const char* key, double value) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%s = %.6g", key, value);
+        return std::string(buf);
+    };
+
+    bool in_battery = false;
+    bool written[5] = {};
+    std::size_t last_key = lines.size();
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        const std::string line = trim(lines[i]);
+        if (!line.empty() && line.front() == '[' && line.back() == ']') {
+            in_battery = trim(line.substr(1, line.size() - 2)) == "battery";
+            if (in_battery)
+                last_key = i;
+            continue;
+        }
+        const auto sep = line.find_first_of("=:");
+        if (!in_battery || line.empty() || line[0] == ';' || line[0] == '#' || sep == std::string::npos)
+            continue;
+        last_key = i;
+        const std::string key = trim(line.substr(0, sep));
+        for (std::size_t v = 0; v < 5; ++v) {
+            if (key == values[v].first) {
+                lines[i] = format(values[v].first, values[v].second);
+                written[v] = true;
+            }
+        }
+    }
+    if (last_key == lines.size()) {
+        lines.emplace_back("[battery]");
+        last_key = lines.size() - 1;
+    }
+    for (std::size_t v = 5; v-- > 0;)
+        if (!written[v])
+            lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(last_key) + 1,
+                         format(values[v].first, values[v].second));
+
+    std::ofstream out(config_path);
+    for (const std::string& line : lines)
+        out << line << '\n';
+    if (!out)
+        throw std::runtime_error("cannot write battery config '" + config_path + "'");
+}
+
+EcmSimulator::EcmSimulator(const EcmParameters& params, double soc0)
+    : params_(params), q_as_(params.capacity_ah * 3600.0)
+{
+    reset(soc0);
+}
+
+void EcmSimulator::reset(double soc0)
+{
+    state_ = EcmState{};
+    state_.soc = soc0;
+}
+
+} // namespace stabl
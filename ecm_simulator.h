@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        ecm_simulator.h
+ * @brief       Equivalent-circuit (2RC Thevenin) battery simulator with exact per-segment stepping
+ *
+ * Native counterpart of simulate_battery() in new_workflow*.ipynb. The model is the same
+ * (OCV(SOC) - R0*I - Vrc1 - Vrc2, coulomb counting for SOC), but instead of integrating the
+ * ODE with solve_ivp each constant-current segment is advanced with its closed-form solution:
+ *
+ *     SOC(t)  = SOC(0) - I*t/Q
+ *     Vrc(t)  = I*R + (Vrc(0) - I*R) * exp(-t/(R*C))
+ *
+ * so the result is exact for piecewise-constant current profiles and no solver runs at all.
+ */
+#ifndef STABL_ECM_SIMULATOR_H
+#define STABL_ECM_SIMULATOR_H
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace stabl {
+
+/**
+ * @brief Not-a-knot cubic spline through the [soc_ocv] points of a battery config
+ *
+ * Reproduces scipy's interp1d(kind='cubic', fill_value="extrapolate") used by the notebooks,
+ * including polynomial extrapolation of the first/last segment outside the SOC range.
+ */
+class OcvCurve {
+public:
+    OcvCurve() = default;
+    /** @p soc in [0, 1] (any order), @p ocv in [V]; both of equal length >= 4. */
+    OcvCurve(std::vector<double> soc, std::vector<double> ocv);
+
+    double operator()(double soc) const;
+    /** dOCV/dSOC [V per unit SOC] */
+    double derivative(double soc) const;
+
+    const std::vector<double>& soc_points() const { return x_; }
+    const std::vector<double>& ocv_points() const { return y_; }
+
+private:
+    std::vector<double> x_;     /**< Knots (SOC), ascending */
+    std::vector<double> y_;     /**< OCV at each knot [V] */
+    std::vector<double> b_;     /**< Linear coefficient per segment */
+    std::vector<double> c_;     /**< Quadratic coefficient per segment */
+    std::vector<double> d_;     /**< Cubic coefficient per segment */
+};
+
+/** Contents of a battery_*.config file ([battery] and [soc_ocv] sections). */
+struct EcmParameters {
+    double r0 = 0.0;            /**< Series resistance [ohm] */
+    double r1 = 0.0;            /**< First RC resistance [ohm], 0 disables the branch */
+    double c1 = 1.0;            /**< First RC capacitance [F] */
+    double r2 = 0.0;            /**< Second RC resistance [ohm], 0 disables the branch */
+    double c2 = 1.0;            /**< Second RC capacitance [F] */
+    double capacity_ah = 0.0;   /**< Capacity [Ah] */
+    double sampling_rate = 1.0; /**< Output sample period [s] */
+    double c_rate = 1.0;        /**< Nominal C-rate used by the profile generators */
+    OcvCurve ocv;               /**< OCV(SOC) curve */
+};
+
+/**
+ * @brief Read a battery config in the INI layout of battery_E60_cell.config
+ *
+ * Missing R2/C2 default to 0/1 like the notebooks. Throws std::runtime_error if the file cannot
+ * be read or a mandatory key is missing.
+ */
+EcmParameters load_ecm_parameters(const std::string& config_path);
+
+/**
+ * @brief Write @p params as a battery config, using @p template_path for everything else
+ *
+ * The template is copied line by line with the R0/R1/C1/R2/C2 values of its [battery] section
+ * replaced (and added if missing), so comments, capacity and the [soc_ocv] table are kept.
+ * Throws std::runtime_error on I/O errors.
+ */
+void save_ecm_parameters(const std::string& template_path, const std::string& config_path,
+                         const EcmParameters& params);
+
+/** Breakpoint of a piecewise-constant current profile: @ref current holds from @ref time on. */
+struct ProfilePoint {
+    double time;                /**< [s] */
+    double current;             /**< [A], positive = discharge */
+};
+
+using CurrentProfile = std::vector<ProfilePoint>;
+
+/** Internal model state. */
+struct EcmState {
+    double soc = 0.0;           /**< State of charge [0..1] */
+    double v_rc1 = 0.0;         /**< Voltage over the first RC branch [V] */
+    double v_rc2 = 0.0;         /**< Voltage over the second RC branch [V] */
+};
+
+/** One output sample, same columns as simulate_battery() returns. */
+struct EcmSample {
+    double time;
+    double current;
+    double voltage;
+    double soc;
+    double ocv;
+};
+
+class EcmSimulator {
+public:
+    explicit EcmSimulator(const EcmParameters& params, double soc0 = 0.9);
+
+    void reset(double soc0);
+
+    /** Advance the state by @p dt seconds at constant @p current (exact). */
+    void advance(double current, double dt)
+    {
+        apply(make_step(current, dt));
+    }
+
+    double ocv() const { return params_.ocv(state_.soc); }
+    double terminal_voltage(double current) const
+    {
+        return ocv() - params_.r0 * current - state_.v_rc1 - state_.v_rc2;
+    }
+
+    const EcmState& state() const { return state_; }
+    EcmState& state() { return state_; }
+    const EcmParameters& parameters() const { return params_; }
+
+    /**
+     * @brief Run a piecewise-constant profile and stream samples to @p sink
+     *
+     * Samples are emitted at profile[0].time + k * @p sample_period for the same k as
+     * np.arange(t0, t_end + sample_period, sample_period) in the notebooks: up to the last
+     * breakpoint and, if that is off the grid, one sample past it with the last current held.
+     * The current of a sample taken exactly on a breakpoint is the one starting there.
+     * @p sink is called as sink(const EcmSample&).
+     */
+    template <typename Sink>
+    void run(const CurrentProfile& profile, double sample_period, Sink&& sink);
+
+private:
+    /** Precomputed update for a fixed (current, dt) pair. */
+    struct Step {
+        double dsoc;
+        double decay1;
+        double target1;
+        double decay2;
+        double target2;
+    };
+
+    Step make_step(double current, double dt) const
+    {
+        Step s;
+        s.dsoc = -current * dt / q_as_;
+        s.decay1 = decay(params_.r1, params_.c1, dt);
+        s.target1 = current * params_.r1;
+        s.decay2 = decay(params_.r2, params_.c2, dt);
+        s.target2 = current * params_.r2;
+        return s;
+    }
+
+    void apply(const Step& s)
+    {
+        state_.soc += s.dsoc;
+        if (params_.r1 != 0.0)
+            state_.v_rc1 = s.target1 + (state_.v_rc1 - s.target1) * s.decay1;
+        if (params_.r2 != 0.0)
+            state_.v_rc2 = s.target2 + (state_.v_rc2 - s.target2) * s.decay2;
+    }
+
+    static double decay(double r, double c, double dt)
+    {
+        const double tau = r * c;
+        return tau > 0.0 ? std::exp(-dt / tau) : 0.0;
+    }
+
+    EcmSample sample(double time, double current) const
+    {
+        const double u_ocv = ocv();
+        return EcmSample{time, current,
+                         u_ocv - params_.r0 * current - state_.v_rc1 - state_.v_rc2,
+                         state_.soc, u_ocv};
+    }
+
+    EcmParameters params_;
+    double q_as_;               /**< Capacity [As] */
+    EcmState state_;
+};
+
+template <typename Sink>
+void EcmSimulator::run(const CurrentProfile& profile, double sample_period, Sink&& sink)
+{
+    if (profile.empty() || !(sample_period > 0.0))
+        return;
+
+    const double t0 = profile.front().time;
+    const double t_end = profile.back().time;
+    /* Same tolerance np.arange(t0, t_end + sr, sr) effectively has on the last sample */
+    const double eps = 1e-9 * sample_period;
+    std::size_t k = 0;
+    double t_now = t0;
+    double t_next = t0;
+
+    for (std::size_t i = 0; i + 1 < profile.size(); ++i) {
+        const double current = profile[i].current;
+        const double t_seg_end = profile[i + 1].time;
+        if (!(t_seg_end > t_now))
+            continue;
+
+        /* All full sample intervals inside the segment share one precomputed step */
+        const Step per_sample = make_step(current, sample_period);
+        bool uniform = false;
+        while (t_next < t_seg_end - eps) {
+            if (uniform)
+                apply(per_sample);
+            else
+                advance(current, t_next - t_now);
+            sink(sample(t_next, current));
+            t_now = t_next;
+            t_next = t0 + static_cast<double>(++k) * sample_period;
+            uniform = true;
+        }
+        advance(current, t_seg_end - t_now);
+        t_now = t_seg_end;
+    }
+
+    const double current = profile.back().current;
+    while (t_next < t_end + sample_period - eps) {
+        advance(current, t_next - t_now);
+        sink(sample(t_next, current));
+        t_now = t_next;
+        t_next = t0 + static_cast<double>(++k) * sample_period;
+    }
+}
+
+} // namespace stabl
+
+#endif /* STABL_ECM_SIMULATOR_H */
@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        estimator_latency.cpp
+ * @brief       Replay traces through the SOC/SOH estimator core and report its per-step latency
+ *
+ * Build:  g++ -O2 -std=c++17 estimator_latency.cpp module_trace.cpp trace_file.cpp -o estimator_latency
+ *
+ * Usage:  estimator_latency <trace>... [options]
+ *   traces are CSV (input_data.csv layout) or binary traces from trace_convert
+ *   --cell-trace        the traces hold one cell (as input_data.csv): scale u_bat by the series
+ *                       cells and the current by the parallel cells and batteries
+ *   --cells             also pass per-cell voltages to every step, to time the cell path
+ *   --repeat <n>        replay every trace n times (default: 1)
+ *   --warmup <n>        untimed replays before the timed ones, so that page faults and cold
+ *                       caches of the first pass do not set the worst case (default: 1)
+ *   --soc0 <x>          initial SOC (default: from the first voltage sample)
+ *   --deadline-us <t>   fail (exit 3) if any step takes longer than t microseconds
+ *   -o <out.csv>        write the estimator outputs of the first trace per step
+ *   --scaling           repeat the measurement for 16..64 series cells and 1..8 parallel
+ *                       batteries; the trace is scaled so every cell sees the same load
+ *
+ * Per-step ticks come from the default cycle counter (rdtsc on x86), converted to nanoseconds
+ * with a frequency measured against std::chrono::steady_clock. On a host the maximum also
+ * contains interrupts and preemption, which the histogram shows as a sparse tail. Pin the
+ * process to an isolated core for a worst case that reflects the estimator alone.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "battery_traits.h"
+#include "soc_estimator.h"
+#include "trace_file.h"
+
+namespace {
+
+using Traits = stabl::LgE60Traits;
+using Counter = stabl::DefaultCycleCounter;
+
+/** The E60 module with a different layout, for the scaling measurement. */
+template <std::size_t Cells, std::size_t Batteries>
+struct ScaledTraits : Traits {
+    static constexpr std::size_t kNumCells = Cells;
+    static constexpr std::size_t kNumParallelBat = Batteries;
+};
+
+void usage()
+{
+    std::fprintf(stderr, "usage: estimator_latency <trace>... [--cell-trace] [--cells] [--repeat n] [--warmup n]\n"
+                         "                         [--soc0 x] [--deadline-us t] [-o out.csv] [--scaling]\n");
+}
+
+/* Counter ticks per nanosecond */
+double calibrate_ticks_per_ns()
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const Counter::Value c0 = Counter::now();
+    while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(50)) {
+    }
+    const Counter::Value c1 = Counter::now();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return static_cast<double>(c1 - c0) / ns;
+}
+
+/** A trace opened for streaming; binary traces are replayed straight from the mapping. */
+struct Trace {
+    std::string name;
+    stabl::ModuleTraceSource source;
+    double u_scale;                     /**< To E60 module volts */
+    double i_scale;                     /**< To E60 module amperes */
+};
+
+Trace open_trace(const std::string& path, bool cell_trace)
+{
+    const double u_scale = cell_trace ? static_cast<double>(Traits::kNumCells) : 1.0;
+    const double i_scale = cell_trace ? static_cast<double>(Traits::kNumParallelCells * Traits::kNumParallelBat) : 1.0;
+    return Trace{path, stabl::ModuleTraceSource(path), u_scale, i_scale};
+}
+
+struct Options {
+    bool cells = false;
+    std::size_t repeat = 1;
+    std::size_t warmup = 1;
+    stabl::EstimatorConfig config;
+};
+
+struct ReplayResult {
+    stabl::CycleStats stats;
+    stabl::EstimatorOutputs outputs{};  /**< At the end of the trace */
+    double bare_ns = 0.0;               /**< Wall time of the uninstrumented replays */
+    std::size_t bare_steps = 0;
+};
+
+/* Written after every bare replay; volatile so the compiler has to compute the sum */
+volatile float g_sink;
+
+/* Replay one trace through SocSohEstimator<T>, scaled from the E60 layout to T's */
+template <typename T>
+ReplayResult replay(const Trace& trace, const Options& opt, FILE* out)
+{
+    const double u_scale = trace.u_scale * static_cast<double>(T::kNumCells) / static_cast<double>(Traits::kNumCells);
+    const double i_scale =
+        trace.i_scale * static_cast<double>(T::kNumParallelBat) / static_cast<double>(Traits::kNumParallelBat);
+
+    /* Spread the module voltage over the cells with a fixed +-5 mV pattern, built before timing */
+    std::vector<float> cells;
+    if (opt.cells) {
+        cells.reserve(trace.source.size() * T::kNumCells);
+        trace.source.for_each_chunk([&](const stabl::ModuleTraceView& rows) {
+            for (std::size_t k = 0; k < rows.size(); ++k)
+                for (std::size_t c = 0; c < T::kNumCells; ++c)
+                    cells.push_back(static_cast<float>(rows.u_bat[k] * trace.u_scale) / Traits::kNumCells +
+                                    0.005f * static_cast<float>(c % 3) - 0.005f);
+        });
+    }
+
+    /* One pass over the trace, chunk by chunk; sink(global sample index, outputs) */
+    const auto run = [&](auto& estimator, auto&& sink) {
+        estimator.reset();
+        std::size_t first = 0;
+        trace.source.for_each_chunk([&](const stabl::ModuleTraceView& rows) {
+            estimator.replay(rows.size(), rows.time, rows.i_mod_avg, rows.i_mod_rms, rows.u_bat, i_scale, u_scale,
+                             [&](std::size_t k, const stabl::EstimatorOutputs& o) { sink(first + k, o); },
+                             opt.cells ? cells.data() + first * T::kNumCells : nullptr, T::kNumCells);
+            first += rows.size();
+        });
+    };
+
+    ReplayResult result;
+    stabl::SocSohEstimator<T, Counter> estimator(opt.config);
+    for (std::size_t r = 0; r < opt.warmup + opt.repeat; ++r) {
+        if (r == opt.warmup)
+            estimator.reset_cycle_stats();
+        run(estimator, [&](std::size_t k, const stabl::EstimatorOutputs& o) {
+            if (out != nullptr && r == opt.warmup)
+                std::fprintf(out, "%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n", k, o.soc, o.soc_conf, o.soh, o.soh_conf,
+                             o.soc_cell_min, o.soc_cell_max);
+        });
+    }
+    result.stats = estimator.cycle_stats();
+    result.outputs = estimator.outputs();
+
+    /* The same replay without instrumentation, for the counter overhead */
+    stabl::SocSohEstimator<T> bare(opt.config);
+    float sink = 0.0f;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < opt.repeat; ++r)
+        run(bare, [&](std::size_t, const stabl::EstimatorOutputs& o) { sink += o.soc; });
+    result.bare_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    result.bare_steps = opt.repeat * trace.source.size();
+    g_sink = sink;  /* keeps the bare replay from being optimised away */
+    return result;
+}
+
+struct LayoutResult {
+    std::size_t cells, batteries, state_bytes;
+    stabl::CycleStats stats;
+    double bare_ns = 0.0;
+    std::size_t bare_steps = 0;
+};
+
+template <typename T>
+LayoutResult replay_all(const std::vector<Trace>& traces, const Options& opt)
+{
+    LayoutResult layout{T::kNumCells, T::kNumParallelBat, sizeof(stabl::SocSohEstimator<T>), {}, 0.0, 0};
+    for (const Trace& t : traces) {
+        const ReplayResult r = replay<T>(t, opt, nullptr);
+        layout.stats.merge(r.stats);
+        layout.bare_ns += r.bare_ns;
+        layout.bare_steps += r.bare_steps;
+    }
+    return layout;
+}
+
+void print_stats(const stabl::CycleStats& stats, double ticks_per_ns, double bare_ns_per_step)
+{
+    const auto line = [&](const char* label, double ticks) {
+        std::printf("%-9s %10.0f ticks %10.1f ns\n", label, ticks, ticks / ticks_per_ns);
+    };
+    std::printf("steps     %llu\n", static_cast<unsigned long long>(stats.count()));
+    line("min", static_cast<double>(stats.min()));
+    line("mean", stats.mean());
+    std::printf("          uninstrumented mean %.1f ns\n", bare_ns_per_step);
+    line("p99 <=", static_cast<double>(stats.quantile_bound(0.99)));
+    line("p99.9 <=", static_cast<double>(stats.quantile_bound(0.999)));
+    line("max", static_cast<double>(stats.max()));
+    std::printf("histogram (ticks):\n");
+    for (std::size_t b = 0; b < stabl::CycleStats::kBins; ++b) {
+        if (stats.bin(b) != 0)
+            std::printf("  [%10llu, %10llu)  %llu\n", static_cast<unsigned long long>(b ? 1ull << b : 0ull),
+                        static_cast<unsigned long long>(2ull << b), static_cast<unsigned long long>(stats.bin(b)));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    bool cell_trace = false;
+    bool scaling = false;
+    double deadline_us = 0.0;
+    std::string out_path;
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--cell-trace")) {
+            cell_trace = true;
+        } else if (!std::strcmp(argv[i], "--cells")) {
+            opt.cells = true;
+        } else if (!std::strcmp(argv[i], "--repeat") && has_value) {
+            opt.repeat = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--warmup") && has_value) {
+            opt.warmup = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--soc0") && has_value) {
+            opt.config.soc0 = static_cast<float>(std::atof(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--deadline-us") && has_value) {
+            deadline_us = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-o") && has_value) {
+            out_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--scaling")) {
+            scaling = true;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || opt.repeat == 0) {
+        usage();
+        return 2;
+    }
+
+    try {
+        std::vector<Trace> traces;
+        for (const std::string& path : paths)
+            traces.push_back(open_trace(path, cell_trace));
+        const double ticks_per_ns = calibrate_ticks_per_ns();
+        std::uint64_t worst = 0;
+
+        if (scaling) {
+            const LayoutResult layouts[] = {
+                replay_all<ScaledTraits<16, 1>>(traces, opt), replay_all<ScaledTraits<16, 2>>(traces, opt),
+                replay_all<ScaledTraits<16, 4>>(traces, opt), replay_all<ScaledTraits<16, 8>>(traces, opt),
+                replay_all<ScaledTraits<32, 1>>(traces, opt), replay_all<ScaledTraits<64, 1>>(traces, opt),
+                replay_all<ScaledTraits<64, 8>>(traces, opt),
+            };
+            std::printf("counter %.3f ticks/ns, cell voltages %s\n", ticks_per_ns, opt.cells ? "on" : "off");
+            std::printf("cells batteries  state[B]   mean[ns]  bare[ns]  p99.9<=[ns]    max[ns]\n");
+            for (const LayoutResult& l : layouts) {
+                std::printf("%5zu %9zu %9zu %10.1f %9.1f %12.1f %10.1f\n", l.cells, l.batteries, l.state_bytes,
+                            l.stats.mean() / ticks_per_ns, l.bare_ns / static_cast<double>(l.bare_steps),
+                            static_cast<double>(l.stats.quantile_bound(0.999)) / ticks_per_ns,
+                            static_cast<double>(l.stats.max()) / ticks_per_ns);
+                worst = l.stats.max() > worst ? l.stats.max() : worst;
+            }
+        } else {
+            stabl::CycleStats total;
+            double bare_ns = 0.0;
+            std::size_t bare_steps = 0;
+            for (std::size_t t = 0; t < traces.size(); ++t) {
+                FILE* out = nullptr;
+                if (t == 0 && !out_path.empty()) {
+                    out = std::fopen(out_path.c_str(), "w");
+                    if (out == nullptr)
+                        throw std::runtime_error("cannot write " + out_path);
+                    std::fprintf(out, "step,soc,soc_conf,soh,soh_conf,soc_cell_min,soc_cell_max\n");
+                }
+                const ReplayResult r = replay<Traits>(traces[t], opt, out);
+                if (out != nullptr)
+                    std::fclose(out);
+                std::printf("%s: %zu steps, soc %.4f (conf %.3f), soh %.4f (conf %.3f)\n", traces[t].name.c_str(),
+                            traces[t].source.size(), static_cast<double>(r.outputs.soc),
+                            static_cast<double>(r.outputs.soc_conf), static_cast<double>(r.outputs.soh),
+                            static_cast<double>(r.outputs.soh_conf));
+                total.merge(r.stats);
+                bare_ns += r.bare_ns;
+                bare_steps += r.bare_steps;
+            }
+            std::printf("\n%zu cells, %zu parallel batteries, estimator state %zu bytes, counter %.3f ticks/ns\n",
+                        Traits::kNumCells, Traits::kNumParallelBat, sizeof(stabl::SocSohEstimator<Traits>),
+                        ticks_per_ns);
+            print_stats(total, ticks_per_ns, bare_ns / static_cast<double>(bare_steps));
+            worst = total.max();
+        }
+
+        if (deadline_us > 0.0) {
+            const double worst_us = static_cast<double>(worst) / ticks_per_ns / 1000.0;
+            std::printf("worst case %.3f us, deadline %.3f us: %s\n", worst_us, deadline_us,
+                        worst_us <= deadline_us ? "met" : "MISSED");
+            if (worst_us > deadline_us)
+                return 3;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "estimator_latency: %s\n", e.what());
+        return 1;
+    }
+}
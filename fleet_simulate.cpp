@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fleet_simulate.cpp
+ * @brief       Site-level cell imbalance / aging run of the SoA fleet simulator
+ *
+ * Build:  g++ -O3 -march=native -std=c++17 -pthread fleet_simulate.cpp fleet_simulator.cpp \
+ *             ecm_simulator.cpp current_profile.cpp -o fleet_simulate
+ *
+ * Usage:  fleet_simulate <cell.config> [options]
+ *   --modules <n>        number of modules (default: 10000)
+ *   --threads <n>        worker threads (default: hardware concurrency)
+ *   --profile step|pwm|<file.csv>
+ *                        cell current profile, scaled by NUM_PARALLEL_CELLS per module (default: step)
+ *   --cycles <n>         repeat the profile n times (default: 1)
+ *   --dt <s>             step size (default: sampling_rate of the config)
+ *   --fade <x>           mean capacity fade per kAh cell throughput (default: 0)
+ *   --seed <n>           spread RNG seed
+ *
+ * The reported cell voltages carry the measurement offsets of battery_info.h
+ * (cellVoltMeasOffsets, only defined with VOLTAGE_MEASUREMENT_COMPENSATION).
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "current_profile.h"
+#include "fleet_simulator.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: fleet_simulate <cell.config> [--modules n] [--threads n] [--profile step|pwm|<file.csv>]\n"
+                 "                      [--cycles n] [--dt s] [--fade x] [--seed n]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+
+    std::size_t modules = 10000;
+    std::size_t threads = 0;
+    std::size_t cycles = 1;
+    std::string profile_name = "step";
+    double dt = 0.0;
+    stabl::FleetSpread spread;
+
+    for (int i = 2; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--modules") && has_value) {
+            modules = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--threads") && has_value) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--profile") && has_value) {
+            profile_name = argv[++i];
+        } else if (!std::strcmp(argv[i], "--cycles") && has_value) {
+            cycles = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--dt") && has_value) {
+            dt = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--fade") && has_value) {
+            spread.fade_per_kah = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && has_value) {
+            spread.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    try {
+        const stabl::EcmParameters cell = stabl::load_ecm_parameters(argv[1]);
+        if (!(dt > 0.0))
+            dt = cell.sampling_rate;
+
+        stabl::CurrentProfile profile;
+        if (profile_name == "step")
+            profile = stabl::generate_step_discharge_profile(cell);
+        else if (profile_name == "pwm")
+            profile = stabl::generate_step_discharge_profile_pwm(cell);
+        else
+            profile = stabl::load_current_profile(profile_name);
+        if (profile.size() < 2)
+            throw std::runtime_error("current profile needs at least two breakpoints");
+
+        stabl::FleetSimulator fleet(cell, modules, 0.9, spread, threads);
+        std::printf("kernel %s, %zu modules, %zu cells, %zu threads\n", stabl::FleetSimulator::kernel_name(),
+                    fleet.num_modules(), fleet.num_cells(), fleet.num_threads());
+
+        const double duration = profile.back().time - profile.front().time;
+        const auto steps_per_cycle = static_cast<std::size_t>(duration / dt);
+        const auto t_start = std::chrono::steady_clock::now();
+        for (std::size_t c = 0; c < cycles; ++c) {
+            std::size_t seg = 0;
+            for (std::size_t k = 0; k < steps_per_cycle; ++k) {
+                const double t = profile.front().time + static_cast<double>(k) * dt;
+                while (seg + 1 < profile.size() && profile[seg + 1].time <= t)
+                    ++seg;
+                const auto current = static_cast<float>(profile[seg].current * stabl::FleetSimulator::kCellsInParallel);
+                fleet.step(current, static_cast<float>(dt));
+            }
+        }
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+        const double steps = static_cast<double>(steps_per_cycle * cycles);
+        std::printf("simulated %.0f s in %.3f s wall: %.0fx real time, %.2f ns/cell-step\n",
+                    steps * dt, wall, steps * dt / wall, wall * 1e9 / (steps * static_cast<double>(fleet.num_cells())));
+
+        /* Imbalance summary over the fleet */
+        float worst_spread = 0.0f;
+        std::size_t worst_module = 0;
+        double mean_spread = 0.0;
+        float min_capacity = 1e30f;
+        for (std::size_t m = 0; m < fleet.num_modules(); ++m) {
+            const float* u = fleet.cell_voltages() + m * stabl::FleetSimulator::kCellsInSeries;
+            const auto mm = std::minmax_element(u, u + stabl::FleetSimulator::kCellsInSeries);
+            const float spread_v = *mm.second - *mm.first;
+            mean_spread += spread_v;
+            if (spread_v > worst_spread) {
+                worst_spread = spread_v;
+                worst_module = m;
+            }
+            for (std::size_t s = 0; s < stabl::FleetSimulator::kCellsInSeries; ++s)
+                for (std::size_t p = 0; p < stabl::FleetSimulator::kCellsInParallel; ++p)
+                    min_capacity = std::min(min_capacity, fleet.capacity_ah(m, s, p));
+        }
+        std::printf("cell voltage spread: mean %.1f mV, worst %.1f mV (module %zu)\n",
+                    1e3 * mean_spread / static_cast<double>(fleet.num_modules()), 1e3 * worst_spread, worst_module);
+        std::printf("lowest remaining cell capacity: %.3f Ah\n", min_capacity);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "fleet_simulate: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fleet_simulator.cpp
+ * @brief       SoA fleet simulator and its SIMD kernels
+ */
+#include "fleet_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+#include "simd_ops.h"
+
+namespace stabl {
+
+namespace {
+
+constexpr std::size_t kSeries = FleetSimulator::kCellsInSeries;
+constexpr std::size_t kParallel = FleetSimulator::kCellsInParallel;
+constexpr float kOcvScale = static_cast<float>(FleetSimulator::kOcvTableSize - 1);
+
+/* Everything a kernel needs for one step, shared read-only by all threads */
+struct StepArgs {
+    const float* ocv_table;
+    const float* offsets;
+    const float* module_current;
+    float* soc;
+    float* v_rc1;
+    float* v_rc2;
+    float* capacity_as;
+    const float* conductance;
+    const float* fade;
+    float* cell_voltage;
+    std::size_t plane;
+    float dt;
+    float r1;
+    float r2;
+    float decay1;
+    float decay2;
+};
+
+using Ops = simd::Native;
+
+static_assert(kSeries % Ops::kWidth == 0, "a module must split into whole SIMD vectors");
+
+/*
+ * One step for modules [begin, end). Per parallel group the terminal voltage follows from
+ *     sum_p (E_p - V) * G_p = I,   E_p = OCV(soc_p) - Vrc1_p - Vrc2_p,   G_p = 1/R0_p
+ * and each cell then carries I_p = (E_p - V) * G_p for the closed-form RC/SOC update.
+ */
+template <typename O>
+void step_kernel(const StepArgs& a, std::size_t begin, std::size_t end)
+{
+    using V = typename O::V;
+    const V dt = O::set1(a.dt);
+    const V r1 = O::set1(a.r1);
+    const V r2 = O::set1(a.r2);
+    const V decay1 = O::set1(a.decay1);
+    const V decay2 = O::set1(a.decay2);
+
+    for (std::size_t m = begin; m < end; ++m) {
+        const V current = O::set1(a.module_current[m]);
+        for (std::size_t s = 0; s < kSeries; s += O::kWidth) {
+            const std::size_t j = m * kSeries + s;
+
+            V e[kParallel];
+            V g[kParallel];
+            V sum_eg = O::set1(0.0f);
+            V sum_g = O::set1(0.0f);
+            for (std::size_t p = 0; p < kParallel; ++p) {
+                const std::size_t k = p * a.plane + j;
+                const V x = O::mul(simd::clamp<O>(O::load(a.soc + k), 0.0f, 1.0f), O::set1(kOcvScale));
+                const V ocv = simd::interpolate<O>(a.ocv_table, x);
+                e[p] = O::sub(O::sub(ocv, O::load(a.v_rc1 + k)), O::load(a.v_rc2 + k));
+                g[p] = O::load(a.conductance + k);
+                sum_eg = O::fmadd(e[p], g[p], sum_eg);
+                sum_g = O::add(sum_g, g[p]);
+            }
+            const V u = O::div(O::sub(sum_eg, current), sum_g);
+
+            for (std::size_t p = 0; p < kParallel; ++p) {
+                const std::size_t k = p * a.plane + j;
+                const V i_cell = O::mul(O::sub(e[p], u), g[p]);
+                const V charge = O::mul(i_cell, dt);
+                V q = O::load(a.capacity_as + k);
+                O::store(a.soc + k, O::sub(O::load(a.soc + k), O::div(charge, q)));
+
+                const V t1 = O::mul(i_cell, r1);
+                O::store(a.v_rc1 + k, O::fmadd(O::sub(O::load(a.v_rc1 + k), t1), decay1, t1));
+                const V t2 = O::mul(i_cell, r2);
+                O::store(a.v_rc2 + k, O::fmadd(O::sub(O::load(a.v_rc2 + k), t2), decay2, t2));
+
+                q = O::sub(q, O::mul(O::load(a.fade + k), O::abs(charge)));
+                O::store(a.capacity_as + k, q);
+            }
+            O::store(a.cell_voltage + j, O::add(u, O::load(a.offsets + s)));
+        }
+    }
+}
+
+} // namespace
+
+FleetSimulator::FleetSimulator(const EcmParameters& cell, std::size_t num_modules, double soc0,
+                               const FleetSpread& spread, std::size_t num_threads)
+    : num_modules_(num_modules),
+      plane_(num_modules * kCellsInSeries),
+      r1_(static_cast<float>(cell.r1)),
+      r2_(static_cast<float>(cell.r2)),
+      tau1_(static_cast<float>(cell.r1 * cell.c1)),
+      tau2_(static_cast<float>(cell.r2 * cell.c2)),
+      ocv_table_(kOcvTableSize + 1),
+      offsets_(std::begin(LgE60Traits::cell_voltage_offsets), std::end(LgE60Traits::cell_voltage_offsets)),
+      soc_(kCellsInParallel * plane_),
+      v_rc1_(kCellsInParallel * plane_, 0.0f),
+      v_rc2_(kCellsInParallel * plane_, 0.0f),
+      capacity_as_(kCellsInParallel * plane_),
+      conductance_(kCellsInParallel * plane_),
+      fade_(kCellsInParallel * plane_),
+      cell_voltage_(plane_),
+      module_current_(num_modules),
+      pool_(num_threads)
+{
+    if (!(cell.r0 > 0.0) || !(cell.capacity_ah > 0.0))
+        throw std::runtime_error("fleet simulation needs R0 > 0 and capacity_Ah > 0");
+
+    for (std::size_t i = 0; i < kOcvTableSize; ++i)
+        ocv_table_[i] = static_cast<float>(cell.ocv(static_cast<double>(i) / (kOcvTableSize - 1)));
+    ocv_table_[kOcvTableSize] = ocv_table_[kOcvTableSize - 1];
+
+    std::mt19937 rng(spread.seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const double q_as = cell.capacity_ah * 3600.0;
+    for (std::size_t k = 0; k < soc_.size(); ++k) {
+        soc_[k] = static_cast<float>(std::min(1.0, std::max(0.0, soc0 + spread.soc_sigma * normal(rng))));
+        capacity_as_[k] = static_cast<float>(q_as * (1.0 + spread.capacity_sigma * normal(rng)));
+        conductance_[k] = static_cast<float>(1.0 / (cell.r0 * std::max(0.1, 1.0 + spread.r0_sigma * normal(rng))));
+        /* Fade per As throughput in As: fraction per kAh * nominal capacity / 3.6e6 As */
+        const double fade = spread.fade_per_kah * std::max(0.0, 1.0 + spread.fade_sigma * normal(rng));
+        fade_[k] = static_cast<float>(fade * q_as / 3.6e6);
+    }
+
+    /* Report the rest voltage until the first step */
+    for (std::size_t m = 0; m < num_modules_; ++m)
+        for (std::size_t s = 0; s < kCellsInSeries; ++s) {
+            double sum = 0.0;
+            for (std::size_t p = 0; p < kCellsInParallel; ++p)
+                sum += ocv_table_[static_cast<std::size_t>(soc_[index(m, s, p)] * kOcvScale + 0.5f)];
+            cell_voltage_[m * kCellsInSeries + s] = static_cast<float>(sum / kCellsInParallel) + offsets_[s];
+        }
+}
+
+void FleetSimulator::set_measurement_offsets(const float* offsets)
+{
+    std::copy(offsets, offsets + kCellsInSeries, offsets_.begin());
+}
+
+const char* FleetSimulator::kernel_name()
+{
+    return Ops::kName;
+}
+
+void FleetSimulator::update_decay(float dt)
+{
+    if (dt == dt_)
+        return;
+    dt_ = dt;
+    decay1_ = tau1_ > 0.0f ? std::exp(-dt / tau1_) : 0.0f;
+    decay2_ = tau2_ > 0.0f ? std::exp(-dt / tau2_) : 0.0f;
+}
+
+void FleetSimulator::step_range(const float* module_current, std::size_t begin, std::size_t end)
+{
+    const StepArgs args{ocv_table_.data(), offsets_.data(), module_current,
+                        soc_.data(), v_rc1_.data(), v_rc2_.data(), capacity_as_.data(),
+                        conductance_.data(), fade_.data(), cell_voltage_.data(),
+                        plane_, dt_, r1_, r2_, decay1_, decay2_};
+    step_kernel<Ops>(args, begin, end);
+}
+
+void FleetSimulator::step(const float* module_current, float dt)
+{
+    update_decay(dt);
+    pool_.parallel_for(num_modules_, [&](std::size_t begin, std::size_t end) {
+        step_range(module_current, begin, end);
+    });
+}
+
+void FleetSimulator::step(float module_current, float dt)
+{
+    std::fill(module_current_.begin(), module_current_.end(), module_current);
+    step(module_current_.data(), dt);
+}
+
+} // namespace stabl
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fleet_simulator.h
+ * @brief       Structure-of-arrays simulator for many modules of NUM_CELLS x NUM_PARALLEL_CELLS cells
+ *
+ * Every cell is its own 2RC equivalent circuit (see ecm_simulator.h) with individual capacity,
+ * R0 and capacity fade. The cells of one parallel group share the terminal voltage, so the module
+ * current is split by the group's OCV/RC/R0 differences every step and cell imbalance develops
+ * naturally. State is kept in contiguous per-quantity arrays (one plane per parallel position,
+ * series cells of all modules back to back) and stepped with AVX-512, AVX2 or scalar kernels,
+ * selected at compile time. Modules are split across a thread pool.
+ */
+#ifndef STABL_FLEET_SIMULATOR_H
+#define STABL_FLEET_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "battery_traits.h"
+#include "ecm_simulator.h"
+#include "thread_pool.h"
+
+namespace stabl {
+
+/** std::allocator replacement returning @p Align byte aligned storage. */
+template <typename T, std::size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    T* allocate(std::size_t n)
+    {
+        void* p = ::operator new(n * sizeof(T), std::align_val_t(Align));
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(Align)); }
+
+    bool operator==(const AlignedAllocator&) const { return true; }
+    bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/** Cell-to-cell manufacturing spread applied when a fleet is created (relative 1-sigma values). */
+struct FleetSpread {
+    double capacity_sigma = 0.01;   /**< Capacity spread */
+    double r0_sigma = 0.05;         /**< R0 spread */
+    double soc_sigma = 0.005;       /**< Initial SOC spread (absolute) */
+    double fade_per_kah = 0.0;      /**< Mean capacity fade per kAh throughput (relative) */
+    double fade_sigma = 0.1;        /**< Spread of the fade rate */
+    std::uint32_t seed = 1;         /**< RNG seed, equal seeds give equal fleets */
+};
+
+class FleetSimulator {
+public:
+    static constexpr std::size_t kCellsInSeries = LgE60Traits::kNumCells;
+    static constexpr std::size_t kCellsInParallel = LgE60Traits::kNumParallelCells;
+    static constexpr std::size_t kOcvTableSize = 1001;  /**< Uniform SOC grid of the OCV table */
+
+    /**
+     * @param cell          Parameters of a single cell (e.g. battery_E60_cell.config)
+     * @param num_modules   Number of modules in the fleet
+     * @param soc0          Mean initial SOC
+     * @param num_threads   Worker threads, 0 = hardware concurrency
+     */
+    FleetSimulator(const EcmParameters& cell, std::size_t num_modules, double soc0 = 0.9,
+                   const FleetSpread& spread = FleetSpread(), std::size_t num_threads = 0);
+
+    /**
+     * @brief Replace the per series position offsets added to the reported cell voltage
+     *
+     * A new fleet starts with LgE60Traits::cell_voltage_offsets (cellVoltMeasOffsets).
+     */
+    void set_measurement_offsets(const float* offsets);
+
+    /**
+     * @brief Advance all cells by @p dt seconds
+     * @param module_current  Current of each module [A], positive = discharge
+     */
+    void step(const float* module_current, float dt);
+
+    /** Same current for every module. */
+    void step(float module_current, float dt);
+
+    std::size_t num_modules() const { return num_modules_; }
+    std::size_t num_cells() const { return num_modules_ * kCellsInSeries * kCellsInParallel; }
+    std::size_t num_threads() const { return pool_.size(); }
+
+    /** Measured voltage of series cell @p series in module @p module after the last step(). */
+    float cell_voltage(std::size_t module, std::size_t series) const
+    {
+        return cell_voltage_[module * kCellsInSeries + series];
+    }
+    /** All measured voltages, module-major, kCellsInSeries per module. */
+    const float* cell_voltages() const { return cell_voltage_.data(); }
+
+    float soc(std::size_t module, std::size_t series, std::size_t parallel) const
+    {
+        return soc_[index(module, series, parallel)];
+    }
+    /** Remaining capacity [Ah] of a cell. */
+    float capacity_ah(std::size_t module, std::size_t series, std::size_t parallel) const
+    {
+        return capacity_as_[index(module, series, parallel)] / 3600.0f;
+    }
+
+    /** Name of the compiled kernel ("avx512", "avx2" or "scalar"). */
+    static const char* kernel_name();
+
+private:
+    std::size_t index(std::size_t module, std::size_t series, std::size_t parallel) const
+    {
+        return parallel * plane_ + module * kCellsInSeries + series;
+    }
+
+    void step_range(const float* module_current, std::size_t begin, std::size_t end);
+    void update_decay(float dt);
+
+    std::size_t num_modules_;
+    std::size_t plane_;                     /**< Cells per parallel plane (num_modules * kCellsInSeries) */
+    float r1_;
+    float r2_;
+    float tau1_;
+    float tau2_;
+    float dt_ = -1.0f;                      /**< dt the decay factors were computed for */
+    float decay1_ = 0.0f;
+    float decay2_ = 0.0f;
+
+    AlignedVector<float> ocv_table_;        /**< OCV on a uniform SOC grid, padded by one entry */
+    AlignedVector<float> offsets_;          /**< Measurement offset per series position */
+
+    /* Per-cell state, kCellsInParallel planes of plane_ entries each */
+    AlignedVector<float> soc_;
+    AlignedVector<float> v_rc1_;
+    AlignedVector<float> v_rc2_;
+    AlignedVector<float> capacity_as_;      /**< Remaining capacity [As] */
+    AlignedVector<float> conductance_;      /**< 1 / R0 [S] */
+    AlignedVector<float> fade_;             /**< Capacity lost per charge throughput [As/As] */
+
+    AlignedVector<float> cell_voltage_;     /**< Measured voltage per series position */
+    AlignedVector<float> module_current_;   /**< Scratch for the broadcast step() overload */
+
+    ThreadPool pool_;
+};
+
+} // namespace stabl
+
+#endif /* STABL_FLEET_SIMULATOR_H */
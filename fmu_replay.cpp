@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fmu_replay.cpp
+ * @brief       Replay module traces through the SOC/SOH FMU, one instance per trace, in parallel
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread fmu_replay.cpp fmu_runner.cpp module_trace.cpp trace_file.cpp \
+ *             -ldl -o fmu_replay
+ *
+ * Usage:  fmu_replay <extracted_fmu_dir> <trace>... [options]
+ *   traces are CSV (input_data.csv layout) or binary traces from trace_convert
+ *   --threads <n>      worker threads (default: hardware concurrency)
+ *   --repeat <n>       replay every trace n times, e.g. to emulate a fleet (default: 1)
+ *   --out-dir <dir>    write <dir>/<trace index>.csv with the FMU outputs per step, creating <dir>
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "fmu_runner.h"
+#include "trace_file.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr, "usage: fmu_replay <extracted_fmu_dir> <trace>... [--threads n] [--repeat n] "
+                         "[--out-dir dir]\n");
+}
+
+bool write_outputs(const std::string& path, const stabl::ModuleTraceSource& trace, const stabl::FmuReplay& replay)
+{
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr)
+        return false;
+    std::fputs("time,soc,soc_conf,soh,soh_conf,i_mod_dr_0,i_mod_dr_1,i_mod_dr_2,i_mod_dr_3,i_mod_dr_4\n", out);
+    std::size_t k = 0;
+    trace.for_each_chunk([&](const stabl::ModuleTraceView& rows) {
+        for (std::size_t r = 0; r < rows.size() && k < replay.outputs.size(); ++r, ++k) {
+            const stabl::FmuOutputs& o = replay.outputs[k];
+            std::fprintf(out, "%.17g,%.17g,%.17g,%.17g,%.17g", rows.time[r], o.soc, o.soc_conf, o.soh, o.soh_conf);
+            for (double dr : o.i_mod_dr)
+                std::fprintf(out, ",%.17g", dr);
+            std::fputc('\n', out);
+        }
+    });
+    return std::fclose(out) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+
+    std::vector<std::string> trace_paths;
+    std::size_t threads = 0;
+    std::size_t repeat = 1;
+    std::string out_dir;
+    for (int i = 2; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--threads") && has_value) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--repeat") && has_value) {
+            repeat = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--out-dir") && has_value) {
+            out_dir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            trace_paths.emplace_back(argv[i]);
+        }
+    }
+
+    try {
+        const stabl::FmuRunner runner(argv[1]);
+
+        /* Binary traces stay mapped and are streamed; repeats share the mapping */
+        std::vector<stabl::ModuleTraceSource> traces;
+        for (const auto& path : trace_paths)
+            traces.emplace_back(path);
+        const std::size_t unique = traces.size();
+        for (std::size_t r = 1; r < repeat; ++r)
+            for (std::size_t i = 0; i < unique; ++i)
+                traces.push_back(traces[i]);
+
+        if (!out_dir.empty())
+            std::filesystem::create_directories(out_dir);
+
+        const auto t_start = std::chrono::steady_clock::now();
+        const std::vector<stabl::FmuReplay> results = runner.replay_all(traces, threads);
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+        std::size_t steps = 0;
+        int status = 0;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            steps += results[i].outputs.size();
+            if (!results[i].error.empty()) {
+                std::fprintf(stderr, "trace %zu: %s\n", i, results[i].error.c_str());
+                status = 1;
+            }
+            if (!out_dir.empty() && !write_outputs(out_dir + "/" + std::to_string(i) + ".csv", traces[i], results[i])) {
+                std::fprintf(stderr, "cannot write outputs of trace %zu to '%s'\n", i, out_dir.c_str());
+                status = 1;
+            }
+        }
+        std::printf("%zu traces, %zu steps in %.3f s: %.0f steps/s\n", results.size(), steps, wall,
+                    static_cast<double>(steps) / wall);
+        return status;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "fmu_replay: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fmu_runner.cpp
+ * @brief       Parallel co-simulation of the StablModule_SOC_SOH FMU over many module traces
+ */
+#include "fmu_runner.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "thread_pool.h"
+
+namespace stabl {
+
+namespace {
+
+/* The subset of the FMI 3.0 C API used here, as declared by fmi3FunctionTypes.h */
+using fmi3Instance = void*;
+using fmi3InstanceEnvironment = void*;
+using fmi3ValueReference = std::uint32_t;
+using fmi3Float64 = double;
+using fmi3Boolean = bool;
+using fmi3String = const char*;
+
+enum fmi3Status { fmi3OK, fmi3Warning, fmi3Discard, fmi3Error, fmi3Fatal };
+
+using fmi3LogMessageCallback = void (*)(fmi3InstanceEnvironment, fmi3Status, fmi3String, fmi3String);
+using fmi3IntermediateUpdateCallback = void (*)(fmi3InstanceEnvironment, fmi3Float64, fmi3Boolean, fmi3Boolean,
+                                                fmi3Boolean, fmi3Boolean, fmi3Boolean*, fmi3Float64*);
+
+using fmi3InstantiateCoSimulationTYPE = fmi3Instance (*)(fmi3String, fmi3String, fmi3String, fmi3Boolean,
+                                                         fmi3Boolean, fmi3Boolean, fmi3Boolean,
+                                                         const fmi3ValueReference*, std::size_t,
+                                                         fmi3InstanceEnvironment, fmi3LogMessageCallback,
+                                                         fmi3IntermediateUpdateCallback);
+using fmi3FreeInstanceTYPE = void (*)(fmi3Instance);
+using fmi3EnterInitializationModeTYPE = fmi3Status (*)(fmi3Instance, fmi3Boolean, fmi3Float64, fmi3Float64,
+                                                       fmi3Boolean, fmi3Float64);
+using fmi3ExitInitializationModeTYPE = fmi3Status (*)(fmi3Instance);
+using fmi3TerminateTYPE = fmi3Status (*)(fmi3Instance);
+using fmi3SetFloat64TYPE = fmi3Status (*)(fmi3Instance, const fmi3ValueReference*, std::size_t,
+                                          const fmi3Float64*, std::size_t);
+using fmi3GetFloat64TYPE = fmi3Status (*)(fmi3Instance, const fmi3ValueReference*, std::size_t,
+                                          fmi3Float64*, std::size_t);
+using fmi3DoStepTYPE = fmi3Status (*)(fmi3Instance, fmi3Float64, fmi3Float64, fmi3Boolean, fmi3Boolean*,
+                                      fmi3Boolean*, fmi3Boolean*, fmi3Float64*);
+
+constexpr std::size_t kNumInputs = 3;
+constexpr std::size_t kNumOutputRefs = 5;
+constexpr std::size_t kNumOutputValues = 4 + FmuOutputs::kNumDerating;
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open '" + path + "'");
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+/* Value of attribute @p name inside the element starting at @p pos */
+std::string attribute(const std::string& xml, std::size_t pos, const std::string& name)
+{
+    const std::size_t end = xml.find('>', pos);
+    const std::string key = " " + name + "=\"";
+    const std::size_t a = xml.find(key, pos);
+    if (a == std::string::npos || a > end)
+        return std::string();
+    const std::size_t v = a + key.size();
+    return xml.substr(v, xml.find('"', v) - v);
+}
+
+struct VariableInfo {
+    std::uint32_t value_reference;
+    std::size_t size;               /**< Number of scalar values (Dimension start) */
+};
+
+/* name -> value reference/size of every Float64 variable */
+std::map<std::string, VariableInfo> float64_variables(const std::string& xml)
+{
+    std::map<std::string, VariableInfo> vars;
+    for (std::size_t pos = xml.find("<Float64"); pos != std::string::npos; pos = xml.find("<Float64", pos + 1)) {
+        const std::string name = attribute(xml, pos, "name");
+        const std::string vr = attribute(xml, pos, "valueReference");
+        if (name.empty() || vr.empty())
+            continue;
+        VariableInfo info{static_cast<std::uint32_t>(std::stoul(vr)), 1};
+        const std::size_t tag_end = xml.find('>', pos);
+        if (tag_end != std::string::npos && xml[tag_end - 1] != '/') {
+            const std::size_t close = xml.find("</Float64>", tag_end);
+            const std::size_t dim = xml.find("<Dimension", tag_end);
+            if (dim != std::string::npos && dim < close)
+                info.size = std::stoul(attribute(xml, dim, "start"));
+        }
+        vars[name] = info;
+    }
+    return vars;
+}
+
+/* Collects the error messages of one instance; they are only reported if an API call fails */
+void log_message(fmi3InstanceEnvironment env, fmi3Status status, fmi3String category, fmi3String message)
+{
+    if (status < fmi3Error || env == nullptr)
+        return;
+    auto* log = static_cast<std::string*>(env);
+    if (!log->empty())
+        *log += "; ";
+    *log += std::string(category ? category : "") + ": " + (message ? message : "");
+}
+
+} // namespace
+
+struct FmuRunner::Library {
+    void* handle = nullptr;
+    fmi3InstantiateCoSimulationTYPE instantiate = nullptr;
+    fmi3FreeInstanceTYPE free_instance = nullptr;
+    fmi3EnterInitializationModeTYPE enter_initialization = nullptr;
+    fmi3ExitInitializationModeTYPE exit_initialization = nullptr;
+    fmi3TerminateTYPE terminate = nullptr;
+    fmi3SetFloat64TYPE set_float64 = nullptr;
+    fmi3GetFloat64TYPE get_float64 = nullptr;
+    fmi3DoStepTYPE do_step = nullptr;
+
+    ~Library()
+    {
+        if (handle != nullptr)
+            dlclose(handle);
+    }
+
+    template <typename F>
+    void resolve(F& fn, const char* name)
+    {
+        fn = reinterpret_cast<F>(dlsym(handle, name));
+        if (fn == nullptr)
+            throw std::runtime_error(std::string("FMU binary does not export ") + name);
+    }
+};
+
+FmuRunner::FmuRunner(const std::string& fmu_dir)
+{
+    const std::string xml = read_file(fmu_dir + "/modelDescription.xml");
+
+    const std::size_t root = xml.find("<fmiModelDescription");
+    const std::size_t cs = xml.find("<CoSimulation");
+    if (root == std::string::npos || cs == std::string::npos)
+        throw std::runtime_error("modelDescription.xml does not describe an FMI CoSimulation FMU");
+    instantiation_token_ = attribute(xml, root, "instantiationToken");
+    model_identifier_ = attribute(xml, cs, "modelIdentifier");
+    /* FMI 3.0 wants an absolute path with a trailing separator */
+    resource_path_ = (std::filesystem::absolute(fmu_dir) / "resources" / "").string();
+
+    const auto vars = float64_variables(xml);
+    const auto lookup = [&](const char* name, std::size_t size) {
+        const auto it = vars.find(name);
+        if (it == vars.end() || it->second.size != size)
+            throw std::runtime_error(std::string("FMU has no Float64 variable '") + name + "' of size " +
+                                     std::to_string(size));
+        return it->second.value_reference;
+    };
+    input_refs_[0] = lookup("i_mod_avg", 1);
+    input_refs_[1] = lookup("i_mod_rms", 1);
+    input_refs_[2] = lookup("u_bat", 1);
+    output_refs_[0] = lookup("soc", 1);
+    output_refs_[1] = lookup("soc_conf", 1);
+    output_refs_[2] = lookup("soh", 1);
+    output_refs_[3] = lookup("soh_conf", 1);
+    output_refs_[4] = lookup("i_mod_dr", FmuOutputs::kNumDerating);
+
+    const std::string binary = fmu_dir + "/binaries/x86_64-linux/" + model_identifier_ + ".so";
+    lib_ = std::make_unique<Library>();
+    lib_->handle = dlopen(binary.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (lib_->handle == nullptr)
+        throw std::runtime_error("cannot load '" + binary + "': " + dlerror());
+    lib_->resolve(lib_->instantiate, "fmi3InstantiateCoSimulation");
+    lib_->resolve(lib_->free_instance, "fmi3FreeInstance");
+    lib_->resolve(lib_->enter_initialization, "fmi3EnterInitializationMode");
+    lib_->resolve(lib_->exit_initialization, "fmi3ExitInitializationMode");
+    lib_->resolve(lib_->terminate, "fmi3Terminate");
+    lib_->resolve(lib_->set_float64, "fmi3SetFloat64");
+    lib_->resolve(lib_->get_float64, "fmi3GetFloat64");
+    lib_->resolve(lib_->do_step, "fmi3DoStep");
+}
+
+FmuRunner::~FmuRunner() = default;
+
+FmuReplay FmuRunner::replay(const ModuleTrace& trace, const std::string& instance_name) const
+{
+    return replay(ModuleTraceSource(trace), instance_name);
+}
+
+FmuReplay FmuRunner::replay(const ModuleTraceSource& trace, const std::string& instance_name) const
+{
+    FmuReplay result;
+    const std::size_t n = trace.size();
+    if (n == 0)
+        return result;
+    std::vector<double> time_scratch;
+    const ModuleTraceView first = trace.chunk(0, time_scratch);
+
+    std::string log;
+    fmi3Instance inst = lib_->instantiate(instance_name.c_str(), instantiation_token_.c_str(),
+                                          resource_path_.c_str(), false, false, false, false, nullptr, 0, &log,
+                                          log_message, nullptr);
+    if (inst == nullptr) {
+        result.error = "fmi3InstantiateCoSimulation failed" + (log.empty() ? "" : ": " + log);
+        return result;
+    }
+
+    bool failed = false;
+    const auto fail = [&](const char* what) {
+        failed = true;
+        result.outputs.clear();
+        result.error = std::string(what) + " failed" + (log.empty() ? "" : ": " + log);
+    };
+
+    double inputs[kNumInputs] = {first.i_mod_avg[0], first.i_mod_rms[0], first.u_bat[0]};
+    if (lib_->enter_initialization(inst, false, 0.0, first.time[0], false, 0.0) > fmi3Warning ||
+        lib_->set_float64(inst, input_refs_, kNumInputs, inputs, kNumInputs) > fmi3Warning ||
+        lib_->exit_initialization(inst) > fmi3Warning) {
+        fail("initialization");
+        lib_->free_instance(inst);
+        return result;
+    }
+
+    /* One step from @p time; false once the FMU failed or asked to terminate */
+    result.outputs.resize(n);
+    std::size_t done = 0;
+    const auto advance = [&](double time, double step) {
+        fmi3Boolean event_needed = false;
+        fmi3Boolean terminate = false;
+        fmi3Boolean early_return = false;
+        fmi3Float64 last_time = 0.0;
+        if (lib_->set_float64(inst, input_refs_, kNumInputs, inputs, kNumInputs) > fmi3Warning) {
+            fail("fmi3SetFloat64");
+            return false;
+        }
+        if (lib_->do_step(inst, time, step, true, &event_needed, &terminate, &early_return, &last_time) >
+            fmi3Warning) {
+            fail("fmi3DoStep");
+            return false;
+        }
+        double values[kNumOutputValues];
+        if (lib_->get_float64(inst, output_refs_, kNumOutputRefs, values, kNumOutputValues) > fmi3Warning) {
+            fail("fmi3GetFloat64");
+            return false;
+        }
+        FmuOutputs& o = result.outputs[done++];
+        o.soc = values[0];
+        o.soc_conf = values[1];
+        o.soh = values[2];
+        o.soh_conf = values[3];
+        std::copy(values + 4, values + kNumOutputValues, o.i_mod_dr);
+        return !terminate;
+    };
+
+    /*
+     * Chunks are read in place. A sample's step lasts until the next sample, which may be in the
+     * next chunk, so each sample is stepped once its successor is known; the last one repeats the
+     * previous step.
+     */
+    double time = first.time[0];
+    double step = 1.0;
+    bool pending = false;
+    bool running = true;
+    for (std::size_t c = 0; c < trace.num_chunks() && running; ++c) {
+        const ModuleTraceView rows = c == 0 ? first : trace.chunk(c, time_scratch);
+        for (std::size_t k = 0; k < rows.size() && running; ++k) {
+            if (pending) {
+                step = rows.time[k] - time;
+                running = advance(time, step);
+            }
+            time = rows.time[k];
+            inputs[0] = rows.i_mod_avg[k];
+            inputs[1] = rows.i_mod_rms[k];
+            inputs[2] = rows.u_bat[k];
+            pending = true;
+        }
+    }
+    if (running)
+        advance(time, step);
+    if (!failed)
+        result.outputs.resize(done);
+
+    /* fmi3Terminate is not allowed after fmi3Error/fmi3Fatal, only fmi3FreeInstance */
+    if (!failed)
+        lib_->terminate(inst);
+    lib_->free_instance(inst);
+    return result;
+}
+
+std::vector<FmuReplay> FmuRunner::replay_all(const std::vector<ModuleTrace>& traces, std::size_t num_threads) const
+{
+    return replay_all(std::vector<ModuleTraceSource>(traces.begin(), traces.end()), num_threads);
+}
+
+std::vector<FmuReplay> FmuRunner::replay_all(const std::vector<ModuleTraceSource>& traces,
+                                             std::size_t num_threads) const
+{
+    std::vector<FmuReplay> results(traces.size());
+    ThreadPool pool(num_threads);
+    std::atomic<std::size_t> next(0);
+    pool.parallel_for(pool.size(), [&](std::size_t, std::size_t) {
+        for (std::size_t i = next++; i < traces.size(); i = next++)
+            results[i] = replay(traces[i], model_identifier_ + "_" + std::to_string(i));
+    });
+    return results;
+}
+
+} // namespace stabl
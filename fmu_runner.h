@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        fmu_runner.h
+ * @brief       Parallel co-simulation of the StablModule_SOC_SOH FMU over many module traces
+ *
+ * The FMU shared library is loaded once; every trace gets its own FMI 3.0 CoSimulation instance
+ * and traces are spread over a thread pool. Per step the runner does exactly one
+ * fmi3SetFloat64 for all inputs, one fmi3DoStep and one fmi3GetFloat64 for all outputs, using
+ * value-reference buffers resolved once from modelDescription.xml.
+ *
+ * The FMU must be extracted and contain binaries/x86_64-linux/<modelIdentifier>.so with
+ * reentrant instances.
+ */
+#ifndef STABL_FMU_RUNNER_H
+#define STABL_FMU_RUNNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "module_trace.h"
+#include "trace_file.h"
+
+namespace stabl {
+
+/** Estimator outputs of one step, in value-reference order of the FMU. */
+struct FmuOutputs {
+    static constexpr std::size_t kNumDerating = 5;
+
+    double soc;
+    double soc_conf;
+    double soh;
+    double soh_conf;
+    double i_mod_dr[kNumDerating];
+};
+
+/** Result of one replayed trace; outputs[k] is the state at the end of the step from time[k]. */
+struct FmuReplay {
+    std::vector<FmuOutputs> outputs;
+    std::string error;              /**< Empty on success, else the failed call and the errors the FMU logged */
+};
+
+class FmuRunner {
+public:
+    /**
+     * @brief Load the FMU from its extracted directory
+     *
+     * Throws std::runtime_error if modelDescription.xml or the Linux binary is missing or does
+     * not export the FMI 3.0 CoSimulation functions.
+     */
+    explicit FmuRunner(const std::string& fmu_dir);
+    ~FmuRunner();
+
+    FmuRunner(const FmuRunner&) = delete;
+    FmuRunner& operator=(const FmuRunner&) = delete;
+
+    /**
+     * @brief Replay one trace in a fresh instance on the calling thread
+     *
+     * The inputs are read chunk by chunk from @p trace, in place for mapped binary traces.
+     */
+    FmuReplay replay(const ModuleTraceSource& trace, const std::string& instance_name) const;
+    /** Same for a trace in memory. */
+    FmuReplay replay(const ModuleTrace& trace, const std::string& instance_name) const;
+
+    /**
+     * @brief Replay all traces, one instance each, on @p num_threads threads
+     *
+     * Traces are handed out one at a time, so long and short traces balance out. A failing
+     * trace reports its error in FmuReplay::error and does not stop the others.
+     */
+    std::vector<FmuReplay> replay_all(const std::vector<ModuleTraceSource>& traces, std::size_t num_threads = 0) const;
+    std::vector<FmuReplay> replay_all(const std::vector<ModuleTrace>& traces, std::size_t num_threads = 0) const;
+
+    const std::string& model_identifier() const { return model_identifier_; }
+
+private:
+    struct Library;
+
+    std::string model_identifier_;
+    std::string instantiation_token_;
+    std::string resource_path_;
+    std::uint32_t input_refs_[3];   /**< i_mod_avg, i_mod_rms, u_bat */
+    std::uint32_t output_refs_[5];  /**< soc, soc_conf, soh, soh_conf, i_mod_dr */
+    std::unique_ptr<Library> lib_;
+};
+
+} // namespace stabl
+
+#endif /* STABL_FMU_RUNNER_H */
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        module_trace.cpp
+ * @brief       Module measurement traces (time, i_mod_avg, i_mod_rms, u_bat)
+ */
+#include "module_trace.h"
+
+#include <stdexcept>
+
+#include "csv_reader.h"
+#include "trace_file.h"
+
+namespace stabl {
+
+namespace {
+
+constexpr const char* kColumns[] = {"time", "i_mod_avg", "i_mod_rms", "u_bat"};
+constexpr std::size_t kNumColumns = sizeof(kColumns) / sizeof(kColumns[0]);
+
+} // namespace
+
+ModuleTrace load_module_trace_csv(const std::string& csv_path)
+{
+    const MappedFile csv(csv_path, true);
+    CsvReader reader(csv.begin(), csv.end(), csv_path);
+
+    std::vector<std::size_t> positions;
+    for (const char* name : kColumns) {
+        positions.push_back(reader.column_index(name));
+        if (positions.back() == reader.columns().size())
+            throw std::runtime_error("trace '" + csv_path + "' has no column '" + name + "'");
+    }
+    reader.select(positions);
+
+    ModuleTrace trace;
+    trace.reserve(reader.remaining() / 32);
+    double values[kNumColumns];
+    while (reader.next(values)) {
+        trace.time.push_back(values[0]);
+        trace.i_mod_avg.push_back(values[1]);
+        trace.i_mod_rms.push_back(values[2]);
+        trace.u_bat.push_back(values[3]);
+    }
+    return trace;
+}
+
+ModuleTrace load_module_trace(const std::string& path)
+{
+    return is_binary_trace(path) ? load_module_trace_binary(path) : load_module_trace_csv(path);
+}
+
+} // namespace stabl
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        module_trace.h
+ * @brief       Module measurement traces (time, i_mod_avg, i_mod_rms, u_bat)
+ *
+ * In-memory form of the FMU input CSV written by new_workflow.ipynb (input_data.csv).
+ */
+#ifndef STABL_MODULE_TRACE_H
+#define STABL_MODULE_TRACE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace stabl {
+
+/** Non-owning columns of consecutive trace samples, e.g. one chunk of a mapped binary trace. */
+struct ModuleTraceView {
+    std::size_t rows = 0;
+    const double* time = nullptr;       /**< [s] */
+    const double* i_mod_avg = nullptr;  /**< Average module current [A] */
+    const double* i_mod_rms = nullptr;  /**< RMS module current [A] */
+    const double* u_bat = nullptr;      /**< Battery voltage [V] */
+
+    std::size_t size() const { return rows; }
+    /** Rows [@p begin, @p end) */
+    ModuleTraceView slice(std::size_t begin, std::size_t end) const
+    {
+        return {end - begin, time + begin, i_mod_avg + begin, i_mod_rms + begin, u_bat + begin};
+    }
+};
+
+/** Column-wise module trace, one entry per sample. */
+struct ModuleTrace {
+    std::vector<double> time;       /**< [s] */
+    std::vector<double> i_mod_avg;  /**< Average module current [A] */
+    std::vector<double> i_mod_rms;  /**< RMS module current [A] */
+    std::vector<double> u_bat;      /**< Battery voltage [V] */
+
+    std::size_t size() const { return time.size(); }
+    void reserve(std::size_t n)
+    {
+        time.reserve(n);
+        i_mod_avg.reserve(n);
+        i_mod_rms.reserve(n);
+        u_bat.reserve(n);
+    }
+    ModuleTraceView view() const { return {size(), time.data(), i_mod_avg.data(), i_mod_rms.data(), u_bat.data()}; }
+};
+
+/**
+ * @brief Read a trace CSV with a header naming the columns
+ *
+ * Columns are matched by name (time, i_mod_avg, i_mod_rms, u_bat), so their order and extra
+ * columns do not matter (rules in csv_reader.h). Throws std::runtime_error on I/O or format errors.
+ */
+ModuleTrace load_module_trace_csv(const std::string& csv_path);
+
+/** Read a trace in either the CSV or the binary format (see trace_file.h), detected by content. */
+ModuleTrace load_module_trace(const std::string& path);
+
+} // namespace stabl
+
+#endif /* STABL_MODULE_TRACE_H */
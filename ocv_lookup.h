@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        ocv_lookup.h
+ * @brief       Constant-time SOC <-> OCV lookup generated at compile time from the traits tables
+ *
+ * OCVcharge/OCVdischarge map a uniform SOC grid to voltage, so ocv_from_soc() is a plain
+ * interpolation. The inverse used to be a search over 1001 entries per cell sample. Here it is
+ * a second table on a uniform *voltage* grid, built by the compiler from the same arrays, so
+ * both directions are one multiply, two gathers and one FMA per cell.
+ *
+ * The source tables are quantised to 1 mV and the curve is very flat around 3.6 V, so several
+ * neighbouring SOC points often share one voltage. Inverting the staircase directly would jump
+ * across every plateau. The inverse table therefore interpolates between the SOC midpoints of
+ * equal-voltage runs, which is continuous, monotonic and never snaps to a plateau edge.
+ * Within a run the forward curve is flat, so a round trip returns the middle of the run: for
+ * E60 (runs of up to three points) that alone is 0.1 % SOC, and the 4096-point inverse grid
+ * adds about 0.003 %. kRoundTripError holds the worst case and is checked at compile time.
+ *
+ * Charge and discharge curves are stored interleaved ([2 * i + branch]), so the hysteresis
+ * branch is a pointer offset instead of a branch in the kernel.
+ */
+#ifndef STABL_OCV_LOOKUP_H
+#define STABL_OCV_LOOKUP_H
+
+#include <array>
+#include <cstddef>
+
+#include "simd_ops.h"
+
+namespace stabl {
+
+/** Hysteresis branch of the OCV curve, also the offset into the interleaved tables. */
+enum class OcvBranch : int {
+    Charge = 0,
+    Discharge = 1,
+};
+
+namespace detail {
+
+/** Two interleaved curves of @p Points entries plus one padding point */
+template <std::size_t Points>
+using InterleavedTable = std::array<float, 2 * (Points + 1)>;
+
+template <typename Traits>
+constexpr const float* ocv_source(int branch)
+{
+    return branch == 0 ? Traits::ocv_charge : Traits::ocv_discharge;
+}
+
+template <typename Traits>
+constexpr InterleavedTable<Traits::kOcvPoints> build_forward_ocv()
+{
+    constexpr std::size_t n = Traits::kOcvPoints;
+    InterleavedTable<n> t{};
+    for (int b = 0; b < 2; ++b) {
+        const float* y = ocv_source<Traits>(b);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i > 0 && y[i] < y[i - 1])
+                throw "OCV table must be non-decreasing";   /* not a constant expression: fails the build */
+            t[2 * i + b] = y[i];
+        }
+        t[2 * n + b] = y[n - 1];
+    }
+    return t;
+}
+
+template <typename Traits, std::size_t Points>
+constexpr InterleavedTable<Points> build_inverse_ocv(float ocv_min, float ocv_max)
+{
+    constexpr std::size_t n = Traits::kOcvPoints;
+    InterleavedTable<Points> t{};
+    for (int b = 0; b < 2; ++b) {
+        const float* y = ocv_source<Traits>(b);
+
+        /* Collapse runs of equal voltage to (voltage, SOC at the middle of the run) */
+        std::array<double, n> u{};
+        std::array<double, n> s{};
+        std::size_t runs = 0;
+        for (std::size_t first = 0; first < n;) {
+            std::size_t last = first;
+            while (last + 1 < n && y[last + 1] == y[first])
+                ++last;
+            u[runs] = y[first];
+            s[runs] = (static_cast<double>(first) + static_cast<double>(last)) / 2.0 / (n - 1);
+            ++runs;
+            first = last + 1;
+        }
+        /* The ends of the curve are 0 and 1 SOC even if the table saturates there */
+        s[0] = 0.0;
+        s[runs - 1] = 1.0;
+
+        std::size_t k = 0;
+        for (std::size_t j = 0; j < Points; ++j) {
+            const double v = ocv_min + (static_cast<double>(ocv_max) - ocv_min) * j / (Points - 1);
+            while (k + 2 < runs && u[k + 1] <= v)
+                ++k;
+            double soc = s[0];
+            if (runs > 1 && v >= u[runs - 1])
+                soc = s[runs - 1];
+            else if (runs > 1 && v > u[0])
+                soc = s[k] + (s[k + 1] - s[k]) * (v - u[k]) / (u[k + 1] - u[k]);
+            t[2 * j + b] = static_cast<float>(soc);
+        }
+        t[2 * Points + b] = t[2 * (Points - 1) + b];
+    }
+    return t;
+}
+
+/* Scalar copy of OcvLookup::run() for one input, usable in constant expressions */
+template <std::size_t Points>
+constexpr float interpolate_table(const InterleavedTable<Points>& t, int branch, float x)
+{
+    constexpr float kLast = static_cast<float>(Points - 1);
+    x = x < 0.0f ? 0.0f : (x > kLast ? kLast : x);
+    const auto i = static_cast<std::size_t>(x);
+    const float lo = t[2 * i + branch];
+    return lo + (x - static_cast<float>(i)) * (t[2 * (i + 1) + branch] - lo);
+}
+
+/* Largest |soc - soc_from_ocv(ocv_from_soc(soc))| over 8 samples per forward grid interval */
+template <std::size_t SocPoints, std::size_t InversePoints>
+constexpr float max_round_trip_error(const InterleavedTable<SocPoints>& forward,
+                                     const InterleavedTable<InversePoints>& inverse, float ocv_min, float scale)
+{
+    constexpr std::size_t kSamples = 8 * (SocPoints - 1);
+    float worst = 0.0f;
+    for (int b = 0; b < 2; ++b) {
+        for (std::size_t j = 0; j <= kSamples; ++j) {
+            const float soc = static_cast<float>(j) / kSamples;
+            const float ocv = interpolate_table<SocPoints>(forward, b, soc * static_cast<float>(SocPoints - 1));
+            const float error = interpolate_table<InversePoints>(inverse, b, (ocv - ocv_min) * scale) - soc;
+            worst = error > worst ? error : (-error > worst ? -error : worst);
+        }
+    }
+    return worst;
+}
+
+} // namespace detail
+
+template <typename Traits, std::size_t InversePoints = 4096>
+class OcvLookup {
+public:
+    static constexpr std::size_t kLanes = Traits::kNumCells;
+    static constexpr std::size_t kSocPoints = Traits::kOcvPoints;
+    static constexpr std::size_t kInversePoints = InversePoints;
+
+    static_assert(kSocPoints >= 2 && kInversePoints >= 2, "OCV tables need at least two points");
+
+    /** Voltage range covered by the inverse tables [V] */
+    static constexpr float kOcvMin = Traits::ocv_charge[0] < Traits::ocv_discharge[0]
+                                         ? Traits::ocv_charge[0] : Traits::ocv_discharge[0];
+    static constexpr float kOcvMax = Traits::ocv_charge[kSocPoints - 1] > Traits::ocv_discharge[kSocPoints - 1]
+                                         ? Traits::ocv_charge[kSocPoints - 1] : Traits::ocv_discharge[kSocPoints - 1];
+
+    using ForwardTable = detail::InterleavedTable<kSocPoints>;
+    using InverseTable = detail::InterleavedTable<kInversePoints>;
+
+    /** OCV [V] per SOC grid point, branches interleaved, one padding point */
+    static constexpr ForwardTable kForward = detail::build_forward_ocv<Traits>();
+    /** SOC [0..1] per voltage grid point, branches interleaved, one padding point */
+    static constexpr InverseTable kInverse = detail::build_inverse_ocv<Traits, kInversePoints>(kOcvMin, kOcvMax);
+
+    /** Worst SOC error of an SOC -> OCV -> SOC round trip */
+    static constexpr float kRoundTripError =
+        detail::max_round_trip_error<kSocPoints, kInversePoints>(kForward, kInverse, kOcvMin,
+                                                                 static_cast<float>(kInversePoints - 1) / (kOcvMax - kOcvMin));
+    static_assert(kRoundTripError <= 0.0011f, "SOC -> OCV -> SOC round trip exceeds 0.11 % SOC");
+
+    /** OCV of a whole module in one call. */
+    static void ocv_from_soc(const float (&soc)[kLanes], float (&ocv)[kLanes], OcvBranch branch)
+    {
+        ocv_from_soc(soc, ocv, kLanes, branch);
+    }
+    /** SOC of a whole module from its rest voltages in one call. */
+    static void soc_from_ocv(const float (&ocv)[kLanes], float (&soc)[kLanes], OcvBranch branch)
+    {
+        soc_from_ocv(ocv, soc, kLanes, branch);
+    }
+
+    /** Batch form for any number of cells. SOC outside [0, 1] is clamped. */
+    static void ocv_from_soc(const float* soc, float* ocv, std::size_t n, OcvBranch branch)
+    {
+        run<kSocPoints>(kForward.data(), soc, ocv, n, branch, 0.0f, static_cast<float>(kSocPoints - 1));
+    }
+    /** Batch form for any number of cells. Voltages outside the table map to 0 or 1. */
+    static void soc_from_ocv(const float* ocv, float* soc, std::size_t n, OcvBranch branch)
+    {
+        run<kInversePoints>(kInverse.data(), ocv, soc, n, branch, kOcvMin, kInverseScale);
+    }
+
+    static float ocv_from_soc(float soc, OcvBranch branch)
+    {
+        float ocv;
+        run<kSocPoints, simd::Scalar>(kForward.data(), &soc, &ocv, 1, branch, 0.0f,
+                                      static_cast<float>(kSocPoints - 1));
+        return ocv;
+    }
+    static float soc_from_ocv(float ocv, OcvBranch branch)
+    {
+        float soc;
+        run<kInversePoints, simd::Scalar>(kInverse.data(), &ocv, &soc, 1, branch, kOcvMin, kInverseScale);
+        return soc;
+    }
+
+private:
+    static constexpr float kInverseScale = static_cast<float>(kInversePoints - 1) / (kOcvMax - kOcvMin);
+
+    /* table[(x - offset) * scale] for every input, clamped to the grid */
+    template <std::size_t Points, typename O = simd::Native>
+    static void run(const float* table, const float* in, float* out, std::size_t n, OcvBranch branch,
+                    float offset, float scale)
+    {
+        const float* base = table + static_cast<int>(branch);
+        constexpr float kLast = static_cast<float>(Points - 1);
+        const std::size_t n_vec = n - n % O::kWidth;
+        std::size_t i = 0;
+        for (; i < n_vec; i += O::kWidth) {
+            const typename O::V x = O::mul(O::sub(O::loadu(in + i), O::set1(offset)), O::set1(scale));
+            O::storeu(out + i, simd::interpolate<O, 2>(base, simd::clamp<O>(x, 0.0f, kLast)));
+        }
+        for (; i < n; ++i) {
+            const float x = (in[i] - offset) * scale;
+            out[i] = simd::interpolate<simd::Scalar, 2>(base, simd::clamp<simd::Scalar>(x, 0.0f, kLast));
+        }
+    }
+};
+
+} // namespace stabl
+
+#endif /* STABL_OCV_LOOKUP_H */
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        parameter_fit.cpp
+ * @brief       Identification of the 2RC equivalent-circuit parameters from measured traces
+ */
+#include "parameter_fit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace stabl {
+
+namespace {
+
+/* Trace in the form the evaluation loop reads: per sample current, hold time, measured voltage
+ * and the charge drawn since the first sample */
+struct PreparedTrace {
+    std::vector<double> current;    /**< [A] */
+    std::vector<double> dt;         /**< Time to the next sample [s], 0 for the last */
+    std::vector<double> voltage;    /**< [V] */
+    std::vector<double> charge;     /**< [As] */
+};
+
+/* Built straight from the chunks of the trace; dt holds the timestamps until the last pass */
+PreparedTrace prepare(const ModuleTraceSource& trace)
+{
+    const std::size_t n = trace.size();
+    if (n < 2)
+        throw std::runtime_error("parameter fit needs traces with at least two samples");
+
+    PreparedTrace p;
+    p.current.reserve(n);
+    p.voltage.reserve(n);
+    p.dt.reserve(n);
+    trace.for_each_chunk([&](const ModuleTraceView& rows) {
+        p.current.insert(p.current.end(), rows.i_mod_avg, rows.i_mod_avg + rows.size());
+        p.voltage.insert(p.voltage.end(), rows.u_bat, rows.u_bat + rows.size());
+        p.dt.insert(p.dt.end(), rows.time, rows.time + rows.size());
+    });
+    p.charge.resize(n);
+    double q = 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+        p.charge[k] = q;
+        p.dt[k] = k + 1 < n ? p.dt[k + 1] - p.dt[k] : 0.0;
+        q += p.current[k] * p.dt[k];
+    }
+    return p;
+}
+
+struct Candidate {
+    double log_tau1;
+    double log_tau2;
+};
+
+struct Score {
+    double sse = std::numeric_limits<double>::infinity();
+    double r[3] = {};               /**< R0, R1, R2 */
+    double soc0 = 0.0;
+};
+
+/* Unknowns of the linear problem: R0, R1, R2 >= 0 and the free SOC0 correction */
+constexpr std::size_t kUnknowns = 4;
+constexpr std::size_t kSocUnknown = 3;
+
+/* Least squares over the subset of unknowns in @p mask; false if singular or a resistance of
+ * the unconstrained optimum of the subset is negative */
+bool solve_subset(const double (&a)[kUnknowns][kUnknowns], const double (&b)[kUnknowns], unsigned mask,
+                  double (&x)[kUnknowns])
+{
+    std::size_t idx[kUnknowns];
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < kUnknowns; ++i)
+        if (mask & (1u << i))
+            idx[n++] = i;
+
+    double m[kUnknowns][kUnknowns + 1];
+    double scale = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        scale = std::max(scale, a[idx[i]][idx[i]]);
+        for (std::size_t j = 0; j < n; ++j)
+            m[i][j] = a[idx[i]][idx[j]];
+        m[i][kUnknowns] = b[idx[i]];
+    }
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < n; ++row)
+            if (std::fabs(m[row][col]) > std::fabs(m[pivot][col]))
+                pivot = row;
+        if (!(std::fabs(m[pivot][col]) > 1e-12 * scale))
+            return false;
+        for (std::size_t j = 0; j <= kUnknowns; ++j)
+            std::swap(m[col][j], m[pivot][j]);
+        for (std::size_t row = col + 1; row < n; ++row) {
+            const double f = m[row][col] / m[col][col];
+            for (std::size_t j = col; j <= kUnknowns; ++j)
+                m[row][j] -= f * m[col][j];
+        }
+    }
+    double sub[kUnknowns];
+    for (std::size_t row = n; row-- > 0;) {
+        double acc = m[row][kUnknowns];
+        for (std::size_t j = row + 1; j < n; ++j)
+            acc -= m[row][j] * sub[j];
+        sub[row] = acc / m[row][row];
+    }
+    std::fill(x, x + kUnknowns, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (idx[i] != kSocUnknown && sub[i] < 0.0)
+            return false;
+        x[idx[i]] = sub[i];
+    }
+    return true;
+}
+
+/* Best solution over all sign-feasible subsets of the resistances (SOC0 always included when
+ * fitted), i.e. the non-negative least squares optimum for at most three resistances */
+double solve_nonnegative(const double (&a)[kUnknowns][kUnknowns], const double (&b)[kUnknowns], double yy,
+                         unsigned allowed, unsigned required, double (&best)[kUnknowns])
+{
+    double best_sse = std::numeric_limits<double>::infinity();
+    std::fill(best, best + kUnknowns, 0.0);
+    for (unsigned mask = 0; mask < (1u << kUnknowns); ++mask) {
+        if ((mask & allowed) != mask || (mask & required) != required)
+            continue;
+        double x[kUnknowns] = {};
+        if (mask != 0 && !solve_subset(a, b, mask, x))
+            continue;
+        double sse = yy;
+        for (std::size_t i = 0; i < kUnknowns; ++i) {
+            sse -= 2.0 * b[i] * x[i];
+            for (std::size_t j = 0; j < kUnknowns; ++j)
+                sse += x[i] * a[i][j] * x[j];
+        }
+        if (sse < best_sse) {
+            best_sse = sse;
+            std::copy(x, x + kUnknowns, best);
+        }
+    }
+    return best_sse;
+}
+
+/*
+ * Score of one (tau1, tau2) candidate; everything lives on the stack. When SOC0 is fitted each
+ * pass also linearises OCV around the current SOC0 guess,
+ *
+ *     OCV(SOC_k + dSOC) ~ OCV(SOC_k) + OCV'(SOC_k) * dSOC,
+ *
+ * and the pass is repeated with the corrected SOC0 (Gauss-Newton) until the correction vanishes.
+ */
+Score evaluate(const PreparedTrace& trace, const OcvCurve& ocv, double q_as, const Candidate& c, double soc0,
+               bool fit_soc, std::size_t rc_branches)
+{
+    constexpr std::size_t kMaxPasses = 8;
+    constexpr double kSocTolerance = 1e-7;
+
+    const double tau1 = std::exp(c.log_tau1);
+    const double tau2 = std::exp(c.log_tau2);
+    const unsigned soc_bit = 1u << kSocUnknown;
+    const unsigned allowed = (rc_branches >= 2 ? 7u : 3u) | (fit_soc ? soc_bit : 0u);
+    const unsigned required = fit_soc ? soc_bit : 0u;
+    const std::size_t n = trace.current.size();
+
+    Score score;
+    for (std::size_t pass = 0; pass < kMaxPasses; ++pass) {
+        double a[kUnknowns][kUnknowns] = {};
+        double b[kUnknowns] = {};
+        double yy = 0.0;
+        double x1 = 0.0;
+        double x2 = 0.0;
+        double last_dt = -1.0;
+        double d1 = 0.0;
+        double d2 = 0.0;
+
+        for (std::size_t k = 0; k < n; ++k) {
+            const double i = trace.current[k];
+            const double soc = soc0 - trace.charge[k] / q_as;
+            const double y = ocv(soc) - trace.voltage[k];
+            const double f[kUnknowns] = {i, x1, x2, fit_soc ? -ocv.derivative(soc) : 0.0};
+            for (std::size_t r = 0; r < kUnknowns; ++r) {
+                for (std::size_t s = r; s < kUnknowns; ++s)
+                    a[r][s] += f[r] * f[s];
+                b[r] += f[r] * y;
+            }
+            yy += y * y;
+
+            const double dt = trace.dt[k];
+            if (dt != last_dt) {
+                d1 = std::exp(-dt / tau1);
+                d2 = std::exp(-dt / tau2);
+                last_dt = dt;
+            }
+            x1 = i + (x1 - i) * d1;
+            x2 = i + (x2 - i) * d2;
+        }
+        for (std::size_t r = 0; r < kUnknowns; ++r)
+            for (std::size_t s = 0; s < r; ++s)
+                a[r][s] = a[s][r];
+
+        double x[kUnknowns];
+        score.sse = solve_nonnegative(a, b, yy, allowed, required, x);
+        std::copy(x, x + 3, score.r);
+        score.soc0 = soc0;
+        if (!fit_soc)
+            break;
+        const double next = std::min(1.0, std::max(0.0, soc0 + x[kSocUnknown]));
+        const bool converged = std::fabs(next - soc0) < kSocTolerance;
+        soc0 = next;
+        if (converged)
+            break;
+    }
+    return score;
+}
+
+std::vector<double> grid(double lo, double hi, std::size_t points)
+{
+    std::vector<double> g(std::max<std::size_t>(points, 1), lo);
+    for (std::size_t i = 1; i < g.size(); ++i)
+        g[i] = lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(g.size() - 1);
+    return g;
+}
+
+/* SOC whose OCV equals the first measured voltage, as start of the SOC0 iteration */
+double initial_soc(const OcvCurve& ocv, double voltage)
+{
+    double lo = 0.0;
+    double hi = 1.0;
+    for (int i = 0; i < 60; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        (ocv(mid) < voltage ? lo : hi) = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+} // namespace
+
+ParameterFitter::ParameterFitter(const EcmParameters& base, const FitOptions& options, std::size_t num_threads)
+    : base_(base), options_(options), pool_(num_threads)
+{
+    if (!(base_.capacity_ah > 0.0))
+        throw std::runtime_error("parameter fit needs a positive capacity");
+    if (!(options_.tau_min > 0.0) || !(options_.tau_max > options_.tau_min))
+        throw std::runtime_error("parameter fit needs 0 < tau_min < tau_max");
+    options_.rc_branches = std::min<std::size_t>(std::max<std::size_t>(options_.rc_branches, 1), 2);
+}
+
+FitResult ParameterFitter::fit(const ModuleTraceSource& trace)
+{
+    return search({&trace}).front();
+}
+
+FitResult ParameterFitter::fit(const ModuleTrace& trace)
+{
+    return fit(ModuleTraceSource(trace));
+}
+
+std::vector<FitResult> ParameterFitter::fit_all(const std::vector<ModuleTraceSource>& traces)
+{
+    std::vector<const ModuleTraceSource*> ptrs;
+    for (const ModuleTraceSource& t : traces)
+        ptrs.push_back(&t);
+    return search(ptrs);
+}
+
+std::vector<FitResult> ParameterFitter::fit_all(const std::vector<ModuleTrace>& traces)
+{
+    return fit_all(std::vector<ModuleTraceSource>(traces.begin(), traces.end()));
+}
+
+std::vector<FitResult> ParameterFitter::search(const std::vector<const ModuleTraceSource*>& traces)
+{
+    const std::size_t num_traces = traces.size();
+    std::vector<PreparedTrace> prepared;
+    for (const ModuleTraceSource* t : traces)
+        prepared.push_back(prepare(*t));
+
+    const bool fit_soc = options_.soc0 < 0.0;
+    const bool two_rc = options_.rc_branches >= 2;
+    const double log_lo = std::log(options_.tau_min);
+    const double log_hi = std::log(options_.tau_max);
+    const double q_as = base_.capacity_ah * 3600.0;
+
+    /* Coarse grid, identical for every trace; tau1 < tau2 as the branches are interchangeable */
+    const std::vector<double> taus = grid(log_lo, log_hi, options_.tau_points);
+    std::vector<Candidate> coarse;
+    for (std::size_t i = 0; i < taus.size(); ++i)
+        for (std::size_t j = two_rc ? i + 1 : i; j < (two_rc ? taus.size() : i + 1); ++j)
+            coarse.push_back(Candidate{taus[i], taus[j]});
+
+    std::vector<std::vector<Candidate>> candidates(num_traces, coarse);
+    std::vector<std::vector<Score>> scores(num_traces);
+    std::vector<Candidate> best(num_traces);
+    std::vector<Score> best_score(num_traces);
+    std::vector<double> soc_start(num_traces, options_.soc0);
+    std::vector<std::size_t> evaluations(num_traces, 0);
+    std::vector<std::size_t> first_task(num_traces + 1);
+    if (fit_soc)
+        for (std::size_t t = 0; t < num_traces; ++t)
+            soc_start[t] = initial_soc(base_.ocv, prepared[t].voltage.front());
+
+    double tau_step = taus.size() > 1 ? taus[1] - taus[0] : 0.0;
+    for (std::size_t level = 0; level <= options_.refinements; ++level) {
+        for (std::size_t t = 0; t < num_traces; ++t) {
+            scores[t].assign(candidates[t].size(), Score());
+            first_task[t + 1] = first_task[t] + candidates[t].size();
+        }
+
+        pool_.run(first_task[num_traces], [&](std::size_t task, std::size_t) {
+            const std::size_t t = static_cast<std::size_t>(
+                std::upper_bound(first_task.begin(), first_task.end(), task) - first_task.begin() - 1);
+            const std::size_t c = task - first_task[t];
+            scores[t][c] = evaluate(prepared[t], base_.ocv, q_as, candidates[t][c], soc_start[t], fit_soc,
+                                    options_.rc_branches);
+        });
+
+        for (std::size_t t = 0; t < num_traces; ++t) {
+            evaluations[t] += candidates[t].size();
+            for (std::size_t c = 0; c < candidates[t].size(); ++c) {
+                if (scores[t][c].sse < best_score[t].sse) {
+                    best_score[t] = scores[t][c];
+                    best[t] = candidates[t][c];
+                }
+            }
+            /* Later levels start the SOC0 iteration where the best candidate converged */
+            if (fit_soc)
+                soc_start[t] = best_score[t].soc0;
+        }
+        if (level == options_.refinements)
+            break;
+
+        /* Next level: 5 points per time constant around the best, half the previous step */
+        tau_step *= 0.5;
+        const double offsets[] = {-2.0, -1.0, 0.0, 1.0, 2.0};
+        for (std::size_t t = 0; t < num_traces; ++t) {
+            candidates[t].clear();
+            for (double d1 : offsets) {
+                for (double d2 : offsets) {
+                    if (!two_rc && d2 != 0.0)
+                        continue;
+                    Candidate c;
+                    c.log_tau1 = std::min(log_hi, std::max(log_lo, best[t].log_tau1 + d1 * tau_step));
+                    c.log_tau2 = std::min(log_hi, std::max(log_lo, best[t].log_tau2 + d2 * tau_step));
+                    candidates[t].push_back(c);
+                }
+            }
+        }
+    }
+
+    std::vector<FitResult> results(num_traces);
+    for (std::size_t t = 0; t < num_traces; ++t) {
+        FitResult& res = results[t];
+        res.params = base_;
+        res.soc0 = best_score[t].soc0;
+        res.evaluations = evaluations[t];
+
+        /* Shorter time constant first; a disabled branch goes last and keeps the base C */
+        std::pair<double, double> rc[2] = {{best_score[t].r[1], std::exp(best[t].log_tau1)},
+                                           {best_score[t].r[2], std::exp(best[t].log_tau2)}};
+        if (rc[0].first == 0.0 || (rc[1].first != 0.0 && rc[1].second < rc[0].second))
+            std::swap(rc[0], rc[1]);
+        res.params.r0 = best_score[t].r[0];
+        res.params.r1 = rc[0].first;
+        res.params.c1 = rc[0].first > 0.0 ? rc[0].second / rc[0].first : base_.c1;
+        res.params.r2 = rc[1].first;
+        res.params.c2 = rc[1].first > 0.0 ? rc[1].second / rc[1].first : base_.c2;
+
+        /* Residuals with the reference model rather than the normal equations */
+        const PreparedTrace& p = prepared[t];
+        EcmSimulator sim(res.params, res.soc0);
+        double sse = 0.0;
+        for (std::size_t k = 0; k < p.current.size(); ++k) {
+            const double e = sim.terminal_voltage(p.current[k]) - p.voltage[k];
+            sse += e * e;
+            res.max_error = std::max(res.max_error, std::fabs(e));
+            sim.advance(p.current[k], p.dt[k]);
+        }
+        res.rms_error = std::sqrt(sse / static_cast<double>(p.current.size()));
+    }
+    return results;
+}
+
+} // namespace stabl
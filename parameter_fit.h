@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        parameter_fit.h
+ * @brief       Identification of the 2RC equivalent-circuit parameters from measured traces
+ *
+ * For fixed initial SOC and RC time constants tau1 = R1*C1, tau2 = R2*C2 the model voltage is
+ * linear in the resistances:
+ *
+ *     OCV(SOC_k) - u_k = R0*I_k + R1*x1_k + R2*x2_k
+ *
+ * where x_k is the current low-pass filtered with the respective time constant. Every candidate
+ * (tau1, tau2) therefore costs one pass over the trace that accumulates a small normal equation,
+ * solved for the best non-negative R0/R1/R2. An unknown initial SOC enters the same equation
+ * through the OCV slope and is refined by repeating the pass (Gauss-Newton). The candidates are
+ * searched on a coarse log-spaced grid that is then refined around the best point. All candidates
+ * of all traces of a level are evaluated as independent tasks on a WorkStealingPool; an
+ * evaluation keeps its state on the stack and does not allocate.
+ */
+#ifndef STABL_PARAMETER_FIT_H
+#define STABL_PARAMETER_FIT_H
+
+#include <cstddef>
+#include <vector>
+
+#include "ecm_simulator.h"
+#include "module_trace.h"
+#include "trace_file.h"
+#include "work_stealing_pool.h"
+
+namespace stabl {
+
+struct FitOptions {
+    double tau_min = 1.0;           /**< Smallest RC time constant searched [s] */
+    double tau_max = 20000.0;       /**< Largest RC time constant searched [s] */
+    std::size_t tau_points = 24;    /**< Log-spaced time constants per branch on the coarse grid */
+    std::size_t rc_branches = 2;    /**< 1 fits R1/C1 only and keeps R2 = 0 */
+    double soc0 = -1.0;             /**< Initial SOC of the traces, < 0 fits it as well */
+    std::size_t refinements = 12;   /**< Grid refinements, each halves the step */
+};
+
+struct FitResult {
+    EcmParameters params;           /**< Base parameters with fitted R0/R1/C1/R2/C2 */
+    double soc0 = 0.0;              /**< Initial SOC used or fitted */
+    double rms_error = 0.0;         /**< RMS voltage error of the fitted model [V] */
+    double max_error = 0.0;         /**< Largest absolute voltage error [V] */
+    std::size_t evaluations = 0;    /**< Candidates evaluated */
+};
+
+class ParameterFitter {
+public:
+    /**
+     * @param base        config supplying OCV curve and capacity; its R/C values are not used
+     * @param num_threads 0 selects std::thread::hardware_concurrency()
+     */
+    explicit ParameterFitter(const EcmParameters& base, const FitOptions& options = FitOptions(),
+                             std::size_t num_threads = 0);
+
+    /**
+     * @brief Fit one trace
+     *
+     * The current of a sample holds until the next sample, positive = discharge, and the RC
+     * branches start relaxed. Throws std::runtime_error for traces with fewer than two samples.
+     */
+    FitResult fit(const ModuleTraceSource& trace);
+    FitResult fit(const ModuleTrace& trace);
+
+    /** Fit every trace independently, sharing the worker threads between all of them. */
+    std::vector<FitResult> fit_all(const std::vector<ModuleTraceSource>& traces);
+    std::vector<FitResult> fit_all(const std::vector<ModuleTrace>& traces);
+
+    std::size_t num_threads() const { return pool_.size(); }
+
+private:
+    std::vector<FitResult> search(const std::vector<const ModuleTraceSource*>& traces);
+
+    EcmParameters base_;
+    FitOptions options_;
+    WorkStealingPool pool_;
+};
+
+} // namespace stabl
+
+#endif /* STABL_PARAMETER_FIT_H */
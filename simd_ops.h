@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        simd_ops.h
+ * @brief       Thin float vector wrappers shared by the SIMD kernels
+ *
+ * Kernels are written once against the static interface below and instantiated with
+ * simd::Native, which is the widest instruction set enabled at compile time
+ * (-mavx512f, -mavx2 -mfma or none). simd::Scalar is always available as reference.
+ */
+#ifndef STABL_SIMD_OPS_H
+#define STABL_SIMD_OPS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace stabl {
+namespace simd {
+
+struct Scalar {
+    using V = float;
+    using I = std::int32_t;
+    static constexpr std::size_t kWidth = 1;
+    static constexpr const char* kName = "scalar";
+
+    static V load(const float* p) { return *p; }
+    static V loadu(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static void storeu(float* p, V v) { *p = v; }
+    static V set1(float x) { return x; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V fmadd(V a, V b, V c) { return a * b + c; }
+    static V abs(V a) { return std::fabs(a); }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V max(V a, V b) { return std::max(a, b); }
+    static float reduce_min(V a) { return a; }
+    static float reduce_max(V a) { return a; }
+
+    static I truncate(V a) { return static_cast<I>(a); }
+    static V to_float(I a) { return static_cast<float>(a); }
+    /** table[i * Scale / sizeof(float)] */
+    template <int Scale>
+    static V gather(const float* table, I i) { return table[i * (Scale / 4)]; }
+};
+
+#if defined(__AVX2__) && defined(__FMA__)
+struct Avx2 {
+    using V = __m256;
+    using I = __m256i;
+    static constexpr std::size_t kWidth = 8;
+    static constexpr const char* kName = "avx2";
+
+    static V load(const float* p) { return _mm256_load_ps(p); }
+    static V loadu(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_store_ps(p, v); }
+    static void storeu(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float x) { return _mm256_set1_ps(x); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+
+    static float reduce_min(V a)
+    {
+        __m128 m = _mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+    static float reduce_max(V a)
+    {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    static I truncate(V a) { return _mm256_cvttps_epi32(a); }
+    static V to_float(I a) { return _mm256_cvtepi32_ps(a); }
+    template <int Scale>
+    static V gather(const float* table, I i) { return _mm256_i32gather_ps(table, i, Scale); }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512 {
+    using V = __m512;
+    using I = __m512i;
+    static constexpr std::size_t kWidth = 16;
+    static constexpr const char* kName = "avx512";
+
+    static V load(const float* p) { return _mm512_load_ps(p); }
+    static V loadu(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, V v) { _mm512_store_ps(p, v); }
+    static void storeu(float* p, V v) { _mm512_storeu_ps(p, v); }
+    static V set1(float x) { return _mm512_set1_ps(x); }
+    static V add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    static V abs(V a) { return _mm512_abs_ps(a); }
+    static V min(V a, V b) { return _mm512_min_ps(a, b); }
+    static V max(V a, V b) { return _mm512_max_ps(a, b); }
+    static float reduce_min(V a) { return _mm512_reduce_min_ps(a); }
+    static float reduce_max(V a) { return _mm512_reduce_max_ps(a); }
+
+    static I truncate(V a) { return _mm512_cvttps_epi32(a); }
+    static V to_float(I a) { return _mm512_cvtepi32_ps(a); }
+    template <int Scale>
+    static V gather(const float* table, I i) { return _mm512_i32gather_ps(i, table, Scale); }
+};
+#endif
+
+#if defined(__AVX512F__)
+using Native = Avx512;
+#elif defined(__AVX2__) && defined(__FMA__)
+using Native = Avx2;
+#else
+using Native = Scalar;
+#endif
+
+/** min(max(a, lo), hi) */
+template <typename O>
+inline typename O::V clamp(typename O::V a, float lo, float hi)
+{
+    return O::min(O::max(a, O::set1(lo)), O::set1(hi));
+}
+
+/**
+ * @brief Linear interpolation in a table on a uniform grid
+ *
+ * @p x is the fractional table position, already clamped to [0, n - 1]. Entries are @p Stride
+ * floats apart (2 for interleaved tables) and @p table must hold one padding entry past the
+ * last grid point.
+ */
+template <typename O, int Stride = 1>
+inline typename O::V interpolate(const float* table, typename O::V x)
+{
+    const typename O::I i = O::truncate(x);
+    const typename O::V f = O::sub(x, O::to_float(i));
+    const typename O::V lo = O::template gather<4 * Stride>(table, i);
+    const typename O::V hi = O::template gather<4 * Stride>(table + Stride, i);
+    return O::fmadd(f, O::sub(hi, lo), lo);
+}
+
+} // namespace simd
+} // namespace stabl
+
+#endif /* STABL_SIMD_OPS_H */
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        soc_estimator.h
+ * @brief       Allocation-free SOC/SOH estimator core with optional per-step cycle statistics
+ *
+ * The same inputs and outputs as the SOC/SOH FMU (i_mod_avg, i_mod_rms, u_bat -> soc, soc_conf,
+ * soh, soh_conf), written so that it runs unchanged on the BMS and on a host:
+ *
+ *  - all state is fixed-size and lives inside the object, nothing is allocated;
+ *  - all arithmetic is float, driven by the traits tables (OCVcharge/OCVdischarge, batCap, batR0);
+ *  - the work per step is a fixed number of operations per parallel battery plus, when cell
+ *    voltages are supplied, one batch OCV inversion over the series cells.
+ *
+ * Every parallel battery runs a scalar extended Kalman filter on its SOC. The prediction is
+ * coulomb counting with its share of the module current. Once both i_mod_avg and i_mod_rms have
+ * stayed below rest_current for rest_time, the correction compares u_bat with
+ * kNumCells * OCV(SOC) - I * batR0. Under load the header has no model of the RC polarisation,
+ * which reaches a few hundred mV per cell, so the voltage is not used there. The OCV branch
+ * follows the sign of the last non-rest current. The OCV slope is a central difference over
+ * slope_span SOC, because the 1 mV quantised table is flat between neighbouring points.
+ *
+ * SOH is the ratio of the measured capacity to batCap. The capacity is the charge counted
+ * between two rest anchors, divided by the difference of their OCV-derived SOCs, and is used
+ * once the swing exceeds soh_min_swing. Each estimate moves soh in proportion to its swing,
+ * and soh_conf grows with the accumulated swing.
+ *
+ * The Counter template argument is the instrumentation hook (see cycle_counter.h): with
+ * NullCycleCounter step() compiles to the bare estimator. Any other counter records the
+ * ticks of every step() in a CycleStats.
+ */
+#ifndef STABL_SOC_ESTIMATOR_H
+#define STABL_SOC_ESTIMATOR_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "cycle_counter.h"
+#include "ocv_lookup.h"
+
+namespace stabl {
+
+struct EstimatorConfig {
+    float soc0 = -1.0f;                 /**< Initial SOC, < 0 takes it from the first voltage sample */
+    float soc_sigma0 = 0.1f;            /**< Initial SOC standard deviation */
+    float soc_sigma_zero_conf = 0.2f;   /**< SOC standard deviation that maps to soc_conf = 0 */
+    float process_noise = 1e-8f;        /**< SOC variance added per second (model error) */
+    float current_noise = 0.5f;         /**< Standard deviation of the module current sensor [A] */
+    float voltage_noise_rest = 0.003f;  /**< Cell voltage error after rest_time at rest [V] */
+    float rest_current = 1.0f;          /**< |i_mod_avg| and i_mod_rms below this count as rest [A] */
+    float rest_time = 600.0f;           /**< Rest before the voltage is treated as OCV [s] */
+    float slope_span = 0.02f;           /**< Half width of the OCV slope difference [SOC] */
+    float soh_min_swing = 0.3f;         /**< SOC swing between rest anchors needed for a capacity estimate */
+    float soh_gain = 0.5f;              /**< Fraction of the capacity error applied per unit swing */
+    float soh_evidence_scale = 2.0f;    /**< Accumulated swing for soh_conf = 1 - 1/e */
+};
+
+/** Estimator outputs, fractions in [0, 1]. */
+struct EstimatorOutputs {
+    float soc;
+    float soc_conf;
+    float soh;
+    float soh_conf;
+    float soc_cell_min;     /**< Lowest cell SOC of the last rested cell voltages, else soc */
+    float soc_cell_max;     /**< Highest cell SOC of the last rested cell voltages, else soc */
+};
+
+template <typename Traits, typename Counter = NullCycleCounter>
+class SocSohEstimator {
+public:
+    static constexpr std::size_t kNumCells = Traits::kNumCells;
+    static constexpr std::size_t kNumBatteries = Traits::kNumParallelBat;
+
+    explicit SocSohEstimator(const EstimatorConfig& config = EstimatorConfig()) : config_(config)
+    {
+        static_assert(std::is_trivially_copyable<SocSohEstimator>::value, "estimator state must not own memory");
+        reset();
+    }
+
+    /** Back to the initial state; the cycle statistics are kept. */
+    void reset()
+    {
+        for (Battery& b : batteries_)
+            b = Battery();
+        initialized_ = false;
+        branch_ = OcvBranch::Discharge;
+        rest_elapsed_ = 0.0f;
+        last_time_ = 0.0;
+        have_time_ = false;
+        outputs_ = EstimatorOutputs{0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f};
+        cell_soc_min_ = cell_soc_max_ = -1.0f;
+    }
+
+    /**
+     * @brief Advance by @p dt seconds
+     *
+     * @param i_mod_avg     module current over the step, positive = discharge [A]
+     * @param i_mod_rms     RMS module current over the step [A]
+     * @param u_bat         module voltage at the end of the step [V]
+     * @param cell_voltages kNumCells series cell voltages, or nullptr
+     */
+    const EstimatorOutputs& step(float dt, float i_mod_avg, float i_mod_rms, float u_bat,
+                                 const float* cell_voltages = nullptr)
+    {
+        if constexpr (Counter::kEnabled) {
+            const typename Counter::Value t0 = Counter::now();
+            update(dt, i_mod_avg, i_mod_rms, u_bat, cell_voltages);
+            stats_.record(static_cast<typename Counter::Value>(Counter::now() - t0));
+        } else {
+            update(dt, i_mod_avg, i_mod_rms, u_bat, cell_voltages);
+        }
+        return outputs_;
+    }
+
+    /**
+     * @brief Step through @p rows consecutive trace samples, e.g. the columns of a mapped trace chunk
+     *
+     * dt is the time since the previous sample and carries over between calls, so a trace can be
+     * fed chunk by chunk; it is 0 for the first sample after reset(). Currents are multiplied by
+     * @p i_scale and voltages by @p u_scale, e.g. to run a cell trace as a module. Rows of
+     * @p cell_voltages, if given, are @p cell_stride apart. @p sink(k, outputs) is called after
+     * sample k.
+     */
+    template <typename Sink>
+    void replay(std::size_t rows, const double* time, const double* i_mod_avg, const double* i_mod_rms,
+                const double* u_bat, double i_scale, double u_scale, Sink&& sink,
+                const float* cell_voltages = nullptr, std::size_t cell_stride = kNumCells)
+    {
+        for (std::size_t k = 0; k < rows; ++k) {
+            const float dt = have_time_ ? static_cast<float>(time[k] - last_time_) : 0.0f;
+            last_time_ = time[k];
+            have_time_ = true;
+            sink(k, step(dt, static_cast<float>(i_mod_avg[k] * i_scale), static_cast<float>(i_mod_rms[k] * i_scale),
+                         static_cast<float>(u_bat[k] * u_scale),
+                         cell_voltages != nullptr ? cell_voltages + k * cell_stride : nullptr));
+        }
+    }
+
+    /** replay() without per-sample outputs; returns the outputs after the last sample. */
+    const EstimatorOutputs& replay(std::size_t rows, const double* time, const double* i_mod_avg,
+                                   const double* i_mod_rms, const double* u_bat, double i_scale = 1.0,
+                                   double u_scale = 1.0)
+    {
+        replay(rows, time, i_mod_avg, i_mod_rms, u_bat, i_scale, u_scale, [](std::size_t, const EstimatorOutputs&) {});
+        return outputs_;
+    }
+
+    const EstimatorOutputs& outputs() const { return outputs_; }
+    const CycleStats& cycle_stats() const { return stats_; }
+    void reset_cycle_stats() { stats_.reset(); }
+
+private:
+    using Lookup = OcvLookup<Traits>;
+
+    static constexpr float kCells = static_cast<float>(kNumCells);
+    static constexpr float kBatteries = static_cast<float>(kNumBatteries);
+    static constexpr float kCellR0 = Traits::kR0 / kCells;     /* batR0 is per battery module */
+
+    struct Battery {
+        float soc = 0.0f;
+        float variance = 0.0f;
+        float soh = 1.0f;
+        float soh_evidence = 0.0f;      /**< Accumulated SOC swing behind soh */
+        float anchor_soc = 0.0f;        /**< OCV SOC at the last rest anchor */
+        float anchor_charge = 0.0f;     /**< Charge since the anchor, positive = discharge [As] */
+        bool anchored = false;
+        bool anchor_live = false;       /**< Still in the rest that set the anchor, keep refreshing it */
+    };
+
+    float ocv(float soc) const { return Lookup::ocv_from_soc(soc, branch_); }
+
+    void update(float dt, float i_mod_avg, float i_mod_rms, float u_bat, const float* cell_voltages)
+    {
+        if (i_mod_avg > config_.rest_current)
+            branch_ = OcvBranch::Discharge;
+        else if (i_mod_avg < -config_.rest_current)
+            branch_ = OcvBranch::Charge;
+        /* i_mod_rms catches zero-mean ripple, which keeps the cells from relaxing */
+        const bool at_rest = std::fabs(i_mod_avg) < config_.rest_current && i_mod_rms < config_.rest_current;
+        rest_elapsed_ = at_rest ? rest_elapsed_ + (dt > 0.0f ? dt : 0.0f) : 0.0f;
+        const bool rested = at_rest && rest_elapsed_ >= config_.rest_time;
+
+        const float current = i_mod_avg / kBatteries;
+        const float u_cell = u_bat / kCells;
+        const float ocv_cell = u_cell + current * kCellR0;
+
+        if (!initialized_) {
+            const float soc0 = config_.soc0 >= 0.0f ? config_.soc0 : Lookup::soc_from_ocv(ocv_cell, branch_);
+            for (Battery& b : batteries_) {
+                b.soc = soc0;
+                b.variance = config_.soc_sigma0 * config_.soc_sigma0;
+            }
+            initialized_ = true;
+        }
+
+        const float r_meas = kCells * kCells * config_.voltage_noise_rest * config_.voltage_noise_rest;
+        const float current_sigma = config_.current_noise / kBatteries;
+        const float rest_soc = rested ? Lookup::soc_from_ocv(ocv_cell, branch_) : 0.0f;
+
+        float soc_sum = 0.0f, variance_sum = 0.0f, soh_sum = 0.0f, evidence_sum = 0.0f;
+        for (Battery& b : batteries_) {
+            /* Predict: coulomb counting with the current capacity estimate */
+            if (dt > 0.0f) {
+                const float capacity_as = 3600.0f * Traits::kCapacityAh * b.soh;
+                const float sigma_soc = current_sigma * dt / capacity_as;
+                b.soc -= current * dt / capacity_as;
+                b.variance += config_.process_noise * dt + sigma_soc * sigma_soc;
+                b.anchor_charge += current * dt;
+            }
+
+            if (!rested) {
+                b.anchor_live = false;
+                accumulate(b, soc_sum, variance_sum, soh_sum, evidence_sum);
+                continue;
+            }
+
+            /* Correct with the relaxed terminal voltage */
+            const float lo = b.soc - config_.slope_span > 0.0f ? b.soc - config_.slope_span : 0.0f;
+            const float hi = b.soc + config_.slope_span < 1.0f ? b.soc + config_.slope_span : 1.0f;
+            const float h = kCells * (ocv(hi) - ocv(lo)) / (hi - lo);
+            const float predicted = kCells * ocv(b.soc) - current * Traits::kR0;
+            const float s = h * h * b.variance + r_meas;
+            const float gain = b.variance * h / s;
+            b.soc += gain * (u_bat - predicted);
+            b.variance *= 1.0f - gain * h;
+            b.soc = b.soc < 0.0f ? 0.0f : (b.soc > 1.0f ? 1.0f : b.soc);
+
+            update_soh(b, rest_soc);
+            accumulate(b, soc_sum, variance_sum, soh_sum, evidence_sum);
+        }
+
+        outputs_.soc = soc_sum / kBatteries;
+        const float sigma = std::sqrt(variance_sum / kBatteries);
+        const float soc_conf = 1.0f - sigma / config_.soc_sigma_zero_conf;
+        outputs_.soc_conf = soc_conf > 0.0f ? soc_conf : 0.0f;
+        outputs_.soh = soh_sum / kBatteries;
+        outputs_.soh_conf = 1.0f - std::exp(-evidence_sum / kBatteries / config_.soh_evidence_scale);
+
+        if (cell_voltages != nullptr && rested)
+            update_cells(cell_voltages, current);
+        outputs_.soc_cell_min = cell_soc_min_ >= 0.0f ? cell_soc_min_ : outputs_.soc;
+        outputs_.soc_cell_max = cell_soc_max_ >= 0.0f ? cell_soc_max_ : outputs_.soc;
+    }
+
+    static void accumulate(const Battery& b, float& soc, float& variance, float& soh, float& evidence)
+    {
+        soc += b.soc;
+        variance += b.variance;
+        soh += b.soh;
+        evidence += b.soh_evidence;
+    }
+
+    void update_soh(Battery& b, float rest_soc) const
+    {
+        if (b.anchored && !b.anchor_live) {
+            const float swing = b.anchor_soc - rest_soc;
+            const float magnitude = std::fabs(swing);
+            if (magnitude < config_.soh_min_swing)
+                return;
+            const float ratio = b.anchor_charge / (3600.0f * Traits::kCapacityAh * swing);
+            const float weight = config_.soh_gain * magnitude < 1.0f ? config_.soh_gain * magnitude : 1.0f;
+            b.soh += weight * (ratio - b.soh);
+            b.soh = b.soh < 0.5f ? 0.5f : (b.soh > 1.2f ? 1.2f : b.soh);
+            b.soh_evidence += magnitude;
+        }
+        b.anchor_soc = rest_soc;
+        b.anchor_charge = 0.0f;
+        b.anchored = true;
+        b.anchor_live = true;
+    }
+
+    void update_cells(const float* cell_voltages, float current)
+    {
+        for (std::size_t i = 0; i < kNumCells; ++i)
+            cell_ocv_[i] = cell_voltages[i] + current * kCellR0;
+        Lookup::soc_from_ocv(cell_ocv_, cell_soc_, branch_);
+        float lo = cell_soc_[0], hi = cell_soc_[0];
+        for (std::size_t i = 1; i < kNumCells; ++i) {
+            lo = cell_soc_[i] < lo ? cell_soc_[i] : lo;
+            hi = cell_soc_[i] > hi ? cell_soc_[i] : hi;
+        }
+        cell_soc_min_ = lo;
+        cell_soc_max_ = hi;
+    }
+
+    EstimatorConfig config_;
+    std::array<Battery, kNumBatteries> batteries_;
+    bool initialized_ = false;
+    OcvBranch branch_ = OcvBranch::Discharge;
+    float rest_elapsed_ = 0.0f;
+    double last_time_ = 0.0;            /**< Timestamp of the last replay() sample */
+    bool have_time_ = false;
+    float cell_ocv_[kNumCells] = {};
+    float cell_soc_[kNumCells] = {};
+    float cell_soc_min_ = -1.0f;
+    float cell_soc_max_ = -1.0f;
+    EstimatorOutputs outputs_{};
+    CycleStats stats_;
+};
+
+} // namespace stabl
+
+#endif /* STABL_SOC_ESTIMATOR_H */
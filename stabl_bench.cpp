@@ -0,0 +1,733 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        stabl_bench.cpp
+ * @brief       Throughput benchmark and golden-trace regression check of the native hot paths
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread -mavx2 -mfma stabl_bench.cpp ecm_simulator.cpp current_profile.cpp \
+ *             fleet_simulator.cpp fmu_runner.cpp module_trace.cpp trace_file.cpp -ldl -o stabl_bench
+ *         or with CMakeLists.txt: cmake -S . -B build && cmake --build build --target golden
+ *         (builds stabl_bench and runs the golden check)
+ *
+ * Usage:  stabl_bench [options]                 run the benchmarks
+ *         stabl_bench --golden <dir> [options]  compare against the reference outputs in <dir>
+ *         stabl_bench --write-golden <dir>      regenerate them (only after a reviewed change)
+ *   --workloads a,b,...     benchmark subset, see --list (default: all available)
+ *   --threads 1,2,4,...     thread counts of the scaling curve (default: powers of two up to the
+ *                           hardware concurrency, and the hardware concurrency itself)
+ *   --min-time <s>          measure every point for at least this long (default: 0.5)
+ *   --csv <out.csv>         also write the results as CSV
+ *   --cell-config <file>    default: battery_E60_cell.config
+ *   --module-config <file>  default: battery_E60_module.config
+ *   --trace <file>          cell trace for the replay workloads (default: input_data.csv)
+ *   --fmu <dir>             extracted SOC/SOH FMU; enables the fmu workload and golden case
+ *   --tolerance-scale <x>   multiply every golden tolerance (default: 1)
+ *   --list                  list workloads and golden cases
+ *
+ * Every workload does a fixed amount of work per repetition and spreads it over a ThreadPool
+ * of the requested size (the fleet uses its own pool), so the thread curve is strong scaling.
+ * A cell-step is one equivalent circuit advanced by one sample: 1 per step for the lumped
+ * cell/module ECM, the estimator and the FMU, one per cell for the fleet, the OCV tables and
+ * the current limits. Peak RSS is the VmHWM of the process, reset before every workload
+ * through /proc/self/clear_refs.
+ *
+ * Golden mode runs deterministic cases and compares each column with the stored CSV (the
+ * reference set lives in tests/golden, every 30th sample). It fails with exit code 3 if a column
+ * is off by more than its tolerance or the layout changed. The tolerances absorb the float
+ * differences between the scalar, AVX2 and AVX-512 kernels; the fmu case needs --fmu and the
+ * shared library for this platform inside the extracted FMU.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "battery_traits.h"
+#include "current_limits.h"
+#include "current_profile.h"
+#include "ecm_simulator.h"
+#include "fleet_simulator.h"
+#include "fmu_runner.h"
+#include "ocv_lookup.h"
+#include "soc_estimator.h"
+#include "thread_pool.h"
+#include "trace_file.h"
+
+namespace {
+
+using Traits = stabl::LgE60Traits;
+using Lookup = stabl::OcvLookup<Traits>;
+
+constexpr std::size_t kInstances = 16;          /* Independent simulations per repetition */
+constexpr std::size_t kOcvCells = 1u << 18;
+constexpr std::size_t kFleetModules = 256;
+constexpr std::size_t kFleetSteps = 600;
+constexpr std::size_t kGoldenDecimation = 30;   /* Keep every n-th sample in the golden files */
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: stabl_bench [--workloads a,b,...] [--threads 1,2,...] [--min-time s] [--csv out.csv]\n"
+                 "                   [--golden dir | --write-golden dir] [--tolerance-scale x]\n"
+                 "                   [--cell-config file] [--module-config file] [--trace file] [--fmu dir] [--list]\n");
+}
+
+struct Options {
+    std::string cell_config = "battery_E60_cell.config";
+    std::string module_config = "battery_E60_module.config";
+    std::string trace = "input_data.csv";
+    std::string fmu_dir;
+};
+
+/* ---- Shared inputs ------------------------------------------------------------------------ */
+
+/** Everything the workloads and golden cases read, loaded once. */
+struct Inputs {
+    explicit Inputs(const Options& opt);
+
+    stabl::EcmParameters cell;
+    stabl::EcmParameters module;
+    stabl::CurrentProfile cell_step, cell_pwm, module_step, module_pwm;
+    stabl::ModuleTraceSource trace;         /**< Cell trace as in input_data.csv, replayed chunk by chunk */
+    std::vector<double> cell_offsets;       /**< Synthetic cell voltages are u_bat + offset, kNumCells */
+    std::vector<float> temperatures;        /**< Sensor temperatures, kNumTempSensors per sample */
+};
+
+/* The estimator runs the cell trace as a module */
+constexpr double kModuleVoltage = Traits::kNumCells;
+constexpr double kModuleCurrent = Traits::kNumParallelCells * Traits::kNumParallelBat;
+
+Inputs::Inputs(const Options& opt)
+    : cell(stabl::load_ecm_parameters(opt.cell_config)), module(stabl::load_ecm_parameters(opt.module_config)),
+      cell_step(stabl::generate_step_discharge_profile(cell)),
+      cell_pwm(stabl::generate_step_discharge_profile_pwm(cell)),
+      module_step(stabl::generate_step_discharge_profile(module)),
+      module_pwm(stabl::generate_step_discharge_profile_pwm(module)), trace(opt.trace)
+{
+    /* Default 30 mV spread and a -5..55 degC ramp: derating_replay --cell-trace --temperature -5:55 */
+    stabl::SyntheticLimitInputs<Traits> synthetic;
+    synthetic.t_lo = -5.0;
+    synthetic.t_hi = 55.0;
+    cell_offsets.resize(synthetic.kNumCells);
+    synthetic.cell_offsets(cell_offsets.data());
+    temperatures.resize(trace.size() * synthetic.kNumTempSensors);
+    synthetic.temperatures(0, trace.size(), trace.size(), temperatures.data());
+}
+
+/* Replay the trace through @p estimator; sink(trace row, time, outputs) */
+template <typename Sink>
+void replay_estimator(const Inputs& in, stabl::SocSohEstimator<Traits>& estimator, Sink&& sink)
+{
+    in.trace.for_each_range(0, in.trace.size(), [&](std::size_t first, const stabl::ModuleTraceView& rows) {
+        estimator.replay(rows.size(), rows.time, rows.i_mod_avg, rows.i_mod_rms, rows.u_bat, kModuleCurrent,
+                         kModuleVoltage,
+                         [&](std::size_t k, const stabl::EstimatorOutputs& o) { sink(first + k, rows.time[k], o); });
+    });
+}
+
+/* Replay the trace through @p engine into out[0..trace.size()) */
+void replay_derating(const Inputs& in, stabl::CurrentLimitEngine<Traits>& engine, stabl::CurrentLimits* out)
+{
+    constexpr std::size_t kSensors = Traits::kNumTempSensors;
+    in.trace.for_each_range(0, in.trace.size(), [&](std::size_t first, const stabl::ModuleTraceView& rows) {
+        engine.update(rows.u_bat, 1.0, in.cell_offsets.data(), in.temperatures.data() + first * kSensors, kSensors,
+                      rows.size(), out + first);
+    });
+}
+
+/* ---- Benchmarks --------------------------------------------------------------------------- */
+
+struct Work {
+    std::size_t steps = 0;
+    std::size_t cell_steps = 0;
+};
+
+/** Builds the state for a thread count (untimed) and returns one timed repetition. */
+using Prepare = std::function<std::function<Work()>(std::size_t threads)>;
+
+struct Workload {
+    const char* name;
+    const char* description;
+    Prepare prepare;
+};
+
+void reset_peak_rss()
+{
+    if (FILE* f = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", f);
+        std::fclose(f);
+    }
+}
+
+/* Peak resident set size [kB] */
+long peak_rss_kb()
+{
+    if (FILE* f = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        long kb = -1;
+        while (std::fgets(line, sizeof(line), f)) {
+            if (!std::strncmp(line, "VmHWM:", 6))
+                kb = std::strtol(line + 6, nullptr, 10);
+        }
+        std::fclose(f);
+        if (kb >= 0)
+            return kb;
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/* Run fn on kInstances instances spread over the pool */
+template <typename F>
+void for_instances(stabl::ThreadPool& pool, F&& fn)
+{
+    pool.parallel_for(kInstances, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            fn(i);
+    });
+}
+
+Prepare ocv_workload(bool inverse)
+{
+    return [inverse](std::size_t threads) {
+        auto pool = std::make_shared<stabl::ThreadPool>(threads);
+        auto in = std::make_shared<std::vector<float>>(kOcvCells);
+        auto out = std::make_shared<std::vector<float>>(kOcvCells);
+        for (std::size_t i = 0; i < kOcvCells; ++i) {
+            const float f = static_cast<float>((i * 2654435761u) % 10007) / 10006.0f;
+            (*in)[i] = inverse ? Lookup::kOcvMin + f * (Lookup::kOcvMax - Lookup::kOcvMin) : f;
+        }
+        return std::function<Work()>([=] {
+            pool->parallel_for(kOcvCells, [&](std::size_t begin, std::size_t end) {
+                const stabl::OcvBranch branch = stabl::OcvBranch::Discharge;
+                if (inverse)
+                    Lookup::soc_from_ocv(in->data() + begin, out->data() + begin, end - begin, branch);
+                else
+                    Lookup::ocv_from_soc(in->data() + begin, out->data() + begin, end - begin, branch);
+            });
+            return Work{kOcvCells, kOcvCells};
+        });
+    };
+}
+
+Prepare ecm_workload(const Inputs& in, bool module, bool pwm)
+{
+    const stabl::EcmParameters* params = module ? &in.module : &in.cell;
+    const stabl::CurrentProfile* profile = module ? (pwm ? &in.module_pwm : &in.module_step)
+                                                  : (pwm ? &in.cell_pwm : &in.cell_step);
+    return [params, profile](std::size_t threads) {
+        auto pool = std::make_shared<stabl::ThreadPool>(threads);
+        auto sinks = std::make_shared<std::vector<double>>(kInstances);
+        return std::function<Work()>([=] {
+            std::vector<std::size_t> samples(kInstances);
+            for_instances(*pool, [&](std::size_t i) {
+                stabl::EcmSimulator sim(*params, 0.9);
+                double sum = 0.0;
+                std::size_t n = 0;
+                sim.run(*profile, params->sampling_rate, [&](const stabl::EcmSample& s) {
+                    sum += s.voltage;
+                    ++n;
+                });
+                (*sinks)[i] = sum;
+                samples[i] = n;
+            });
+            std::size_t steps = 0;
+            for (std::size_t n : samples)
+                steps += n;
+            return Work{steps, steps};
+        });
+    };
+}
+
+Prepare fleet_workload(const Inputs& in)
+{
+    const stabl::EcmParameters* cell = &in.cell;
+    const float current = static_cast<float>(in.cell.capacity_ah * in.cell.c_rate * stabl::FleetSimulator::kCellsInParallel);
+    return [cell, current](std::size_t threads) {
+        auto fleet = std::make_shared<stabl::FleetSimulator>(*cell, kFleetModules, 0.9, stabl::FleetSpread(), threads);
+        return std::function<Work()>([=] {
+            for (std::size_t k = 0; k < kFleetSteps; ++k)
+                fleet->step(k % 2 ? current : -current, 1.0f);   /* alternate so SOC stays in range */
+            return Work{kFleetSteps, kFleetSteps * fleet->num_cells()};
+        });
+    };
+}
+
+Prepare estimator_workload(const Inputs& in)
+{
+    const Inputs* p = &in;
+    return [p](std::size_t threads) {
+        auto pool = std::make_shared<stabl::ThreadPool>(threads);
+        auto sinks = std::make_shared<std::vector<float>>(kInstances);
+        return std::function<Work()>([=] {
+            for_instances(*pool, [&](std::size_t i) {
+                stabl::SocSohEstimator<Traits> estimator;
+                replay_estimator(*p, estimator, [](std::size_t, double, const stabl::EstimatorOutputs&) {});
+                (*sinks)[i] = estimator.outputs().soc;
+            });
+            const std::size_t steps = kInstances * p->trace.size();
+            return Work{steps, steps};
+        });
+    };
+}
+
+Prepare derating_workload(const Inputs& in)
+{
+    const Inputs* p = &in;
+    return [p](std::size_t threads) {
+        using Engine = stabl::CurrentLimitEngine<Traits>;
+        auto pool = std::make_shared<stabl::ThreadPool>(threads);
+        auto out = std::make_shared<std::vector<stabl::CurrentLimits>>(kInstances * p->trace.size());
+        return std::function<Work()>([=] {
+            const std::size_t n = p->trace.size();
+            for_instances(*pool, [&](std::size_t i) {
+                Engine engine;
+                replay_derating(*p, engine, out->data() + i * n);
+            });
+            return Work{kInstances * n, kInstances * n * Engine::kNumCells};
+        });
+    };
+}
+
+Prepare fmu_workload(const Inputs& in, const std::string& fmu_dir)
+{
+    const Inputs* p = &in;
+    return [p, fmu_dir](std::size_t threads) {
+        auto runner = std::make_shared<stabl::FmuRunner>(fmu_dir);
+        auto traces = std::make_shared<std::vector<stabl::ModuleTraceSource>>(kInstances, p->trace);
+        return std::function<Work()>([=] {
+            const std::vector<stabl::FmuReplay> results = runner->replay_all(*traces, threads);
+            std::size_t steps = 0;
+            for (const stabl::FmuReplay& r : results) {
+                if (!r.error.empty())
+                    throw std::runtime_error("fmu: " + r.error);
+                steps += r.outputs.size();
+            }
+            return Work{steps, steps};
+        });
+    };
+}
+
+std::vector<Workload> make_workloads(const Inputs& in, const Options& opt)
+{
+    std::vector<Workload> w = {
+        {"ocv-forward", "OcvLookup SOC -> OCV, batch", ocv_workload(false)},
+        {"ocv-inverse", "OcvLookup OCV -> SOC, batch", ocv_workload(true)},
+        {"ecm-cell-step", "EcmSimulator, cell config, step discharge", ecm_workload(in, false, false)},
+        {"ecm-cell-pwm", "EcmSimulator, cell config, 20 s/10 s PWM discharge", ecm_workload(in, false, true)},
+        {"ecm-module-step", "EcmSimulator, module config, step discharge", ecm_workload(in, true, false)},
+        {"ecm-module-pwm", "EcmSimulator, module config, 20 s/10 s PWM discharge", ecm_workload(in, true, true)},
+        {"fleet", "FleetSimulator, 256 modules of 16s3p cells", fleet_workload(in)},
+        {"estimator", "SocSohEstimator replay of the trace", estimator_workload(in)},
+        {"derating", "CurrentLimitEngine replay of the trace, 16 cells", derating_workload(in)},
+    };
+    if (!opt.fmu_dir.empty())
+        w.push_back({"fmu", "SOC/SOH FMU replay of the trace", fmu_workload(in, opt.fmu_dir)});
+    return w;
+}
+
+struct Result {
+    std::string workload;
+    std::size_t threads;
+    double steps_per_s;
+    double ns_per_cell_step;
+    double peak_rss_mb;
+    double wall_s;
+};
+
+Result measure(const Workload& w, std::size_t threads, double min_time)
+{
+    reset_peak_rss();
+    const std::function<Work()> run = w.prepare(threads);
+    run();  /* warm-up: first touch of tables and buffers */
+    Work total;
+    double wall = 0.0;
+    do {
+        const auto t0 = std::chrono::steady_clock::now();
+        const Work work = run();
+        wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        total.steps += work.steps;
+        total.cell_steps += work.cell_steps;
+    } while (wall < min_time);
+    return Result{w.name, threads, static_cast<double>(total.steps) / wall,
+                  wall * 1e9 / static_cast<double>(total.cell_steps), static_cast<double>(peak_rss_kb()) / 1024.0,
+                  wall};
+}
+
+/* ---- Golden traces ------------------------------------------------------------------------ */
+
+struct Table {
+    std::vector<std::string> columns;
+    std::vector<double> tolerances;         /**< Allowed absolute error per column */
+    std::vector<std::vector<double>> rows;
+};
+
+struct GoldenCase {
+    const char* name;
+    std::function<Table()> produce;
+};
+
+Table ocv_case(bool inverse)
+{
+    Table t;
+    t.columns = {inverse ? "ocv" : "soc", "charge", "discharge"};
+    t.tolerances = {1e-6, 1e-5, 1e-5};  /* the input column differs by float contraction only */
+    for (int i = 0; i <= 200; ++i) {
+        const float f = static_cast<float>(i) / 200.0f;
+        const float x = inverse ? Lookup::kOcvMin + f * (Lookup::kOcvMax - Lookup::kOcvMin) : f;
+        const auto eval = [&](stabl::OcvBranch b) {
+            return inverse ? Lookup::soc_from_ocv(x, b) : Lookup::ocv_from_soc(x, b);
+        };
+        t.rows.push_back({x, eval(stabl::OcvBranch::Charge), eval(stabl::OcvBranch::Discharge)});
+    }
+    return t;
+}
+
+Table ecm_case(const stabl::EcmParameters& params, const stabl::CurrentProfile& profile)
+{
+    Table t;
+    t.columns = {"time", "voltage", "soc"};
+    t.tolerances = {1e-9, 1e-5, 1e-6};
+    stabl::EcmSimulator sim(params, 0.9);
+    std::size_t k = 0;
+    sim.run(profile, params.sampling_rate, [&](const stabl::EcmSample& s) {
+        if (k++ % kGoldenDecimation == 0)
+            t.rows.push_back({s.time, s.voltage, s.soc});
+    });
+    return t;
+}
+
+Table fleet_case(const Inputs& in)
+{
+    Table t;
+    t.columns = {"time", "cell_voltage", "mean_voltage", "soc"};
+    t.tolerances = {1e-9, 1e-4, 1e-4, 1e-5};
+    stabl::FleetSimulator fleet(in.cell, 8, 0.9, stabl::FleetSpread(), 1);
+    const stabl::CurrentProfile& profile = in.cell_step;
+    const double dt = in.cell.sampling_rate;
+    const auto steps = static_cast<std::size_t>((profile.back().time - profile.front().time) / dt);
+    std::size_t seg = 0;
+    for (std::size_t k = 0; k < steps; ++k) {
+        const double time = profile.front().time + static_cast<double>(k) * dt;
+        while (seg + 1 < profile.size() && profile[seg + 1].time <= time)
+            ++seg;
+        fleet.step(static_cast<float>(profile[seg].current * stabl::FleetSimulator::kCellsInParallel),
+                   static_cast<float>(dt));
+        if (k % kGoldenDecimation == 0) {
+            double mean = 0.0;
+            const std::size_t series = fleet.num_modules() * stabl::FleetSimulator::kCellsInSeries;
+            for (std::size_t i = 0; i < series; ++i)
+                mean += fleet.cell_voltages()[i];
+            t.rows.push_back({time + dt, fleet.cell_voltage(0, 0), mean / static_cast<double>(series),
+                              fleet.soc(0, 0, 0)});
+        }
+    }
+    return t;
+}
+
+Table estimator_case(const Inputs& in)
+{
+    Table t;
+    t.columns = {"time", "soc", "soc_conf", "soh", "soh_conf"};
+    t.tolerances = {1e-9, 1e-4, 1e-4, 1e-4, 1e-4};
+    stabl::SocSohEstimator<Traits> estimator;
+    replay_estimator(in, estimator, [&](std::size_t k, double time, const stabl::EstimatorOutputs& o) {
+        if (k % kGoldenDecimation == 0)
+            t.rows.push_back({time, o.soc, o.soc_conf, o.soh, o.soh_conf});
+    });
+    return t;
+}
+
+/* Timestamps of the trace, for the golden rows */
+std::vector<double> trace_times(const Inputs& in)
+{
+    std::vector<double> time;
+    in.trace.for_each_chunk(
+        [&](const stabl::ModuleTraceView& rows) { time.insert(time.end(), rows.time, rows.time + rows.size()); });
+    return time;
+}
+
+Table derating_case(const Inputs& in)
+{
+    Table t;
+    t.columns = {"time"};
+    t.columns.insert(t.columns.end(), std::begin(stabl::CurrentLimits::kNames), std::end(stabl::CurrentLimits::kNames));
+    t.tolerances = {1e-9, 1e-3, 1e-3, 1e-5, 1e-5, 1e-5};
+    stabl::CurrentLimitEngine<Traits> engine;
+    std::vector<stabl::CurrentLimits> limits(in.trace.size());
+    replay_derating(in, engine, limits.data());
+    const std::vector<double> time = trace_times(in);
+    for (std::size_t k = 0; k < limits.size(); k += kGoldenDecimation) {
+        double dr[stabl::CurrentLimits::kSize];
+        limits[k].store(dr);
+        t.rows.push_back({time[k], dr[0], dr[1], dr[2], dr[3], dr[4]});
+    }
+    return t;
+}
+
+Table fmu_case(const Inputs& in, const std::string& fmu_dir)
+{
+    Table t;
+    t.columns = {"time", "soc", "soc_conf", "soh", "soh_conf", "i_mod_dr_0", "i_mod_dr_1", "i_mod_dr_2",
+                 "i_mod_dr_3", "i_mod_dr_4"};
+    t.tolerances = std::vector<double>(t.columns.size(), 1e-6);
+    t.tolerances[0] = 1e-9;
+    const stabl::FmuRunner runner(fmu_dir);
+    const stabl::FmuReplay replay = runner.replay(in.trace, "golden");
+    if (!replay.error.empty())
+        throw std::runtime_error("fmu: " + replay.error);
+    const std::vector<double> time = trace_times(in);
+    for (std::size_t k = 0; k < replay.outputs.size(); k += kGoldenDecimation) {
+        const stabl::FmuOutputs& o = replay.outputs[k];
+        t.rows.push_back({time[k], o.soc, o.soc_conf, o.soh, o.soh_conf, o.i_mod_dr[0], o.i_mod_dr[1],
+                          o.i_mod_dr[2], o.i_mod_dr[3], o.i_mod_dr[4]});
+    }
+    return t;
+}
+
+std::vector<GoldenCase> make_golden_cases(const Inputs& in, const Options& opt)
+{
+    std::vector<GoldenCase> c = {
+        {"ocv-forward", [] { return ocv_case(false); }},
+        {"ocv-inverse", [] { return ocv_case(true); }},
+        {"ecm-cell-step", [&] { return ecm_case(in.cell, in.cell_step); }},
+        {"ecm-cell-pwm", [&] { return ecm_case(in.cell, in.cell_pwm); }},
+        {"ecm-module-step", [&] { return ecm_case(in.module, in.module_step); }},
+        {"ecm-module-pwm", [&] { return ecm_case(in.module, in.module_pwm); }},
+        {"fleet", [&] { return fleet_case(in); }},
+        {"estimator", [&] { return estimator_case(in); }},
+        {"derating", [&] { return derating_case(in); }},
+    };
+    if (!opt.fmu_dir.empty())
+        c.push_back({"fmu", [&] { return fmu_case(in, opt.fmu_dir); }});
+    return c;
+}
+
+void write_table(const std::string& path, const Table& t)
+{
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr)
+        throw std::runtime_error("cannot write " + path);
+    for (std::size_t j = 0; j < t.columns.size(); ++j)
+        std::fprintf(out, "%s%s", j ? "," : "", t.columns[j].c_str());
+    std::fputc('\n', out);
+    for (const std::vector<double>& row : t.rows) {
+        for (std::size_t j = 0; j < row.size(); ++j)
+            std::fprintf(out, "%s%.10g", j ? "," : "", row[j]);
+        std::fputc('\n', out);
+    }
+    if (std::fclose(out) != 0)
+        throw std::runtime_error("cannot write " + path);
+}
+
+/* Stored rows, or an empty table with an empty header if the file is missing */
+Table read_table(const std::string& path)
+{
+    Table t;
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line))
+        return t;
+    std::stringstream header(line);
+    for (std::string name; std::getline(header, name, ',');)
+        t.columns.push_back(name);
+    while (std::getline(in, line)) {
+        if (line.empty())
+            continue;
+        std::vector<double> row;
+        const char* p = line.c_str();
+        for (;;) {
+            char* end = nullptr;
+            row.push_back(std::strtod(p, &end));
+            if (end == p)
+                throw std::runtime_error(path + ": malformed row");
+            if (*end != ',')
+                break;
+            p = end + 1;
+        }
+        t.rows.push_back(std::move(row));
+    }
+    return t;
+}
+
+/* Compare one case and print a line per column, true if within tolerance */
+bool compare(const char* name, const Table& actual, const Table& golden, double tolerance_scale)
+{
+    if (golden.columns.empty()) {
+        std::printf("%-16s FAIL  no reference file\n", name);
+        return false;
+    }
+    if (golden.columns != actual.columns || golden.rows.size() != actual.rows.size()) {
+        std::printf("%-16s FAIL  layout changed: %zu rows x %zu columns, reference %zu x %zu\n", name,
+                    actual.rows.size(), actual.columns.size(), golden.rows.size(), golden.columns.size());
+        return false;
+    }
+    bool ok = true;
+    for (std::size_t j = 0; j < actual.columns.size(); ++j) {
+        double worst = 0.0;
+        std::size_t worst_row = 0;
+        for (std::size_t k = 0; k < actual.rows.size(); ++k) {
+            const double d = std::fabs(actual.rows[k][j] - golden.rows[k][j]);
+            if (!(d <= worst)) {
+                worst = d;
+                worst_row = k;
+            }
+        }
+        /* The files hold 10 significant digits; allow for that rounding on top of the tolerance */
+        const double stored = golden.rows.empty() ? 0.0 : golden.rows[worst_row][j];
+        const double limit = actual.tolerances[j] * tolerance_scale + 1e-9 * std::fabs(stored);
+        const bool pass = worst <= limit;
+        ok = ok && pass;
+        std::printf("%-16s %s  %-14s max error %.3g (row %zu), tolerance %.3g\n", name, pass ? "ok  " : "FAIL",
+                    actual.columns[j].c_str(), worst, worst_row, limit);
+    }
+    return ok;
+}
+
+std::vector<std::string> split(const std::string& s)
+{
+    std::vector<std::string> parts;
+    std::stringstream ss(s);
+    for (std::string part; std::getline(ss, part, ',');) {
+        if (!part.empty())
+            parts.push_back(part);
+    }
+    return parts;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    std::vector<std::string> selected;
+    std::vector<std::size_t> thread_counts;
+    double min_time = 0.5;
+    double tolerance_scale = 1.0;
+    std::string csv_path, golden_dir, write_golden_dir;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--workloads") && has_value) {
+            selected = split(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--threads") && has_value) {
+            for (const std::string& t : split(argv[++i]))
+                thread_counts.push_back(std::strtoul(t.c_str(), nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--min-time") && has_value) {
+            min_time = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--csv") && has_value) {
+            csv_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--golden") && has_value) {
+            golden_dir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--write-golden") && has_value) {
+            write_golden_dir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--tolerance-scale") && has_value) {
+            tolerance_scale = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--cell-config") && has_value) {
+            opt.cell_config = argv[++i];
+        } else if (!std::strcmp(argv[i], "--module-config") && has_value) {
+            opt.module_config = argv[++i];
+        } else if (!std::strcmp(argv[i], "--trace") && has_value) {
+            opt.trace = argv[++i];
+        } else if (!std::strcmp(argv[i], "--fmu") && has_value) {
+            opt.fmu_dir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--list")) {
+            list = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (thread_counts.empty()) {
+        const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t t = 1; t < hw; t *= 2)
+            thread_counts.push_back(t);
+        thread_counts.push_back(hw);
+    }
+
+    try {
+        const Inputs inputs(opt);
+        const std::vector<Workload> workloads = make_workloads(inputs, opt);
+        const std::vector<GoldenCase> cases = make_golden_cases(inputs, opt);
+
+        if (list) {
+            for (const Workload& w : workloads)
+                std::printf("workload  %-16s %s\n", w.name, w.description);
+            for (const GoldenCase& c : cases)
+                std::printf("golden    %s\n", c.name);
+            return 0;
+        }
+
+        if (!write_golden_dir.empty()) {
+            for (const GoldenCase& c : cases) {
+                const Table t = c.produce();
+                write_table(write_golden_dir + "/" + c.name + ".csv", t);
+                std::printf("%-16s %zu rows\n", c.name, t.rows.size());
+            }
+            return 0;
+        }
+
+        if (!golden_dir.empty()) {
+            bool ok = true;
+            for (const GoldenCase& c : cases)
+                ok = compare(c.name, c.produce(), read_table(golden_dir + "/" + c.name + ".csv"), tolerance_scale) && ok;
+            std::printf("%s\n", ok ? "golden traces match" : "golden traces DIFFER");
+            return ok ? 0 : 3;
+        }
+
+        for (const std::string& name : selected) {
+            if (std::none_of(workloads.begin(), workloads.end(), [&](const Workload& w) { return name == w.name; }))
+                throw std::runtime_error("unknown workload " + name + " (see --list)");
+        }
+        std::vector<Result> results;
+        std::printf("%-16s %7s %14s %14s %12s %8s %8s\n", "workload", "threads", "steps/s", "ns/cell-step",
+                    "peak RSS MB", "wall s", "speedup");
+        for (const Workload& w : workloads) {
+            if (!selected.empty() && std::find(selected.begin(), selected.end(), w.name) == selected.end())
+                continue;
+            double base = 0.0;
+            for (std::size_t threads : thread_counts) {
+                const Result r = measure(w, threads, min_time);
+                if (base == 0.0)
+                    base = r.steps_per_s;
+                std::printf("%-16s %7zu %14.4g %14.3f %12.1f %8.2f %8.2f\n", r.workload.c_str(), r.threads,
+                            r.steps_per_s, r.ns_per_cell_step, r.peak_rss_mb, r.wall_s, r.steps_per_s / base);
+                std::fflush(stdout);
+                results.push_back(r);
+            }
+        }
+
+        if (!csv_path.empty()) {
+            FILE* out = std::fopen(csv_path.c_str(), "w");
+            if (out == nullptr)
+                throw std::runtime_error("cannot write " + csv_path);
+            std::fputs("workload,threads,steps_per_s,ns_per_cell_step,peak_rss_mb,wall_s\n", out);
+            for (const Result& r : results)
+                std::fprintf(out, "%s,%zu,%.6g,%.6g,%.3f,%.4f\n", r.workload.c_str(), r.threads, r.steps_per_s,
+                             r.ns_per_cell_step, r.peak_rss_mb, r.wall_s);
+            std::fclose(out);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "stabl_bench: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        stub_fmu.cpp
+ * @brief       Stand-in for the StablModule_SOC_SOH FMU binary, for testing FmuRunner
+ *
+ * Exports the FMI 3.0 CoSimulation functions FmuRunner uses, with the variables of
+ * modelDescription.xml next to this file. The outputs are simple functions of the inputs and
+ * the step, so a test can compute them independently:
+ *
+ *   soc         starts at 50 and integrates -i_mod_avg * h / 36
+ *   soc_conf    time at the end of the step
+ *   soh         i_mod_rms of the step
+ *   soh_conf    u_bat of the step
+ *   i_mod_dr[j] j * i_mod_avg
+ *
+ * The stub checks the calling sequence: a call in the wrong state, a step that does not start
+ * where the previous one ended, or any call but fmi3FreeInstance after an error aborts the
+ * process. The instance name selects test behaviour: a name ending in "_fail" fails the third
+ * fmi3DoStep, one ending in "_log" logs an error on every step without failing.
+ *
+ * Build: built by CMakeLists.txt as <fmu>/binaries/x86_64-linux/StablModule_SOC_SOH_stub.so
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+/* The subset of the FMI 3.0 C API that FmuRunner uses, as declared by fmi3FunctionTypes.h */
+using fmi3Instance = void*;
+using fmi3InstanceEnvironment = void*;
+using fmi3ValueReference = std::uint32_t;
+using fmi3Float64 = double;
+using fmi3Boolean = bool;
+using fmi3String = const char*;
+
+enum fmi3Status { fmi3OK, fmi3Warning, fmi3Discard, fmi3Error, fmi3Fatal };
+
+using fmi3LogMessageCallback = void (*)(fmi3InstanceEnvironment, fmi3Status, fmi3String, fmi3String);
+using fmi3IntermediateUpdateCallback = void (*)(fmi3InstanceEnvironment, fmi3Float64, fmi3Boolean, fmi3Boolean,
+                                                fmi3Boolean, fmi3Boolean, fmi3Boolean*, fmi3Float64*);
+
+constexpr const char* kToken = "StablModule_SOC_SOH_stub";
+constexpr std::size_t kNumDerating = 5;
+constexpr int kFailingStep = 3;
+
+enum class State { Instantiated, Initialization, StepMode, Terminated, Error };
+
+enum ValueReference : fmi3ValueReference {
+    kIModRms = 0,
+    kIModAvg = 1,
+    kUBat = 2,
+    kSoc = 4,
+    kSocConf = 5,
+    kSoh = 6,
+    kSohConf = 7,
+    kIModDr = 8,
+};
+
+struct Instance {
+    std::string name;
+    fmi3InstanceEnvironment env;
+    fmi3LogMessageCallback logger;
+    bool fail = false;              /**< Fail the kFailingStep-th step */
+    bool log_only = false;          /**< Log an error on every step */
+    State state = State::Instantiated;
+    int steps = 0;
+    double time = 0.0;
+    double i_mod_avg = 0.0;
+    double i_mod_rms = 0.0;
+    double u_bat = 0.0;
+    double soc = 50.0;
+    double soh = 0.0;
+    double soh_conf = 0.0;
+    double i_mod_dr[kNumDerating] = {};
+};
+
+bool ends_with(const std::string& s, const char* suffix)
+{
+    const std::size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+[[noreturn]] void abort_call(const Instance* inst, const char* call)
+{
+    std::fprintf(stderr, "stub FMU: %s not allowed in this state (instance '%s')\n", call,
+                 inst ? inst->name.c_str() : "null");
+    std::abort();
+}
+
+Instance* expect(fmi3Instance instance, const char* call, State a, State b = State::Error)
+{
+    Instance* inst = static_cast<Instance*>(instance);
+    if (inst == nullptr || (inst->state != a && (b == State::Error || inst->state != b)))
+        abort_call(inst, call);
+    return inst;
+}
+
+void log(const Instance* inst, fmi3Status status, const char* message)
+{
+    if (inst->logger != nullptr)
+        inst->logger(inst->env, status, "logStatusError", message);
+}
+
+fmi3Status error(Instance* inst, const char* message)
+{
+    inst->state = State::Error;
+    log(inst, fmi3Error, message);
+    return fmi3Error;
+}
+
+} // namespace
+
+extern "C" {
+
+fmi3Instance fmi3InstantiateCoSimulation(fmi3String instanceName, fmi3String instantiationToken,
+                                         fmi3String resourcePath, fmi3Boolean, fmi3Boolean, fmi3Boolean,
+                                         fmi3Boolean, const fmi3ValueReference*, std::size_t,
+                                         fmi3InstanceEnvironment instanceEnvironment,
+                                         fmi3LogMessageCallback logMessage, fmi3IntermediateUpdateCallback)
+{
+    if (instanceName == nullptr || instantiationToken == nullptr || std::strcmp(instantiationToken, kToken) != 0)
+        return nullptr;
+    /* FMI 3.0: absolute path with a trailing separator */
+    const std::string resources = resourcePath ? resourcePath : "";
+    if (resources.empty() || resources.front() != '/' || resources.back() != '/')
+        return nullptr;
+
+    Instance* inst = new Instance;
+    inst->name = instanceName;
+    inst->env = instanceEnvironment;
+    inst->logger = logMessage;
+    inst->fail = ends_with(inst->name, "_fail");
+    inst->log_only = ends_with(inst->name, "_log");
+    return inst;
+}
+
+void fmi3FreeInstance(fmi3Instance instance)
+{
+    delete static_cast<Instance*>(instance);
+}
+
+fmi3Status fmi3EnterInitializationMode(fmi3Instance instance, fmi3Boolean, fmi3Float64, fmi3Float64 startTime,
+                                       fmi3Boolean, fmi3Float64)
+{
+    Instance* inst = expect(instance, "fmi3EnterInitializationMode", State::Instantiated);
+    inst->state = State::Initialization;
+    inst->time = startTime;
+    return fmi3OK;
+}
+
+fmi3Status fmi3ExitInitializationMode(fmi3Instance instance)
+{
+    Instance* inst = expect(instance, "fmi3ExitInitializationMode", State::Initialization);
+    inst->state = State::StepMode;
+    return fmi3OK;
+}
+
+fmi3Status fmi3Terminate(fmi3Instance instance)
+{
+    Instance* inst = expect(instance, "fmi3Terminate", State::StepMode);
+    inst->state = State::Terminated;
+    return fmi3OK;
+}
+
+fmi3Status fmi3SetFloat64(fmi3Instance instance, const fmi3ValueReference valueReferences[],
+                          std::size_t nValueReferences, const fmi3Float64 values[], std::size_t nValues)
+{
+    Instance* inst = expect(instance, "fmi3SetFloat64", State::Initialization, State::StepMode);
+    if (nValues != nValueReferences)
+        return error(inst, "fmi3SetFloat64: one value per input expected");
+    for (std::size_t i = 0; i < nValueReferences; ++i) {
+        switch (valueReferences[i]) {
+        case kIModRms: inst->i_mod_rms = values[i]; break;
+        case kIModAvg: inst->i_mod_avg = values[i]; break;
+        case kUBat:    inst->u_bat = values[i]; break;
+        default:       return error(inst, "fmi3SetFloat64: not an input");
+        }
+    }
+    return fmi3OK;
+}
+
+fmi3Status fmi3GetFloat64(fmi3Instance instance, const fmi3ValueReference valueReferences[],
+                          std::size_t nValueReferences, fmi3Float64 values[], std::size_t nValues)
+{
+    Instance* inst = expect(instance, "fmi3GetFloat64", State::Initialization, State::StepMode);
+    std::size_t v = 0;
+    for (std::size_t i = 0; i < nValueReferences; ++i) {
+        const std::size_t size = valueReferences[i] == kIModDr ? kNumDerating : 1;
+        if (v + size > nValues)
+            return error(inst, "fmi3GetFloat64: nValues too small");
+        switch (valueReferences[i]) {
+        case kSoc:     values[v] = inst->soc; break;
+        case kSocConf: values[v] = inst->time; break;
+        case kSoh:     values[v] = inst->soh; break;
+        case kSohConf: values[v] = inst->soh_conf; break;
+        case kIModDr:
+            for (std::size_t j = 0; j < kNumDerating; ++j)
+                values[v + j] = inst->i_mod_dr[j];
+            break;
+        default:       return error(inst, "fmi3GetFloat64: not an output");
+        }
+        v += size;
+    }
+    if (v != nValues)
+        return error(inst, "fmi3GetFloat64: nValues does not match the variables");
+    return fmi3OK;
+}
+
+fmi3Status fmi3DoStep(fmi3Instance instance, fmi3Float64 currentCommunicationPoint,
+                      fmi3Float64 communicationStepSize, fmi3Boolean, fmi3Boolean* eventHandlingNeeded,
+                      fmi3Boolean* terminateSimulation, fmi3Boolean* earlyReturn, fmi3Float64* lastSuccessfulTime)
+{
+    Instance* inst = expect(instance, "fmi3DoStep", State::StepMode);
+    if (currentCommunicationPoint != inst->time)
+        abort_call(inst, "fmi3DoStep from a time the previous step did not end at");
+    if (inst->fail && ++inst->steps == kFailingStep)
+        return error(inst, "forced failure");
+    if (inst->log_only)
+        log(inst, fmi3Error, "error logged by a successful step");
+
+    const double h = communicationStepSize;
+    inst->soc -= inst->i_mod_avg * h / 36.0;
+    inst->soh = inst->i_mod_rms;
+    inst->soh_conf = inst->u_bat;
+    for (std::size_t j = 0; j < kNumDerating; ++j)
+        inst->i_mod_dr[j] = static_cast<double>(j) * inst->i_mod_avg;
+    inst->time = currentCommunicationPoint + h;
+
+    *eventHandlingNeeded = false;
+    *terminateSimulation = false;
+    *earlyReturn = false;
+    *lastSuccessfulTime = inst->time;
+    return fmi3OK;
+}
+
+} // extern "C"
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        test_balancing.cpp
+ * @brief       Event-driven BalancingSimulator::run() against the fixed-step reference
+ *
+ * Ten daily cycles of a module with enough SOC spread that every cell balances. The event-driven
+ * run solves threshold crossings exactly; the 1 s reference decides once per step. Counts must
+ * agree, and times may differ by about one step per transition.
+ *
+ * Build: built and registered with ctest by CMakeLists.txt
+ * Usage: test_balancing
+ */
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "balancing_simulator.h"
+#include "battery_traits.h"
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++g_failures;
+    }
+}
+
+void check_near(double value, double reference, double tolerance, const std::string& what)
+{
+    check(std::fabs(value - reference) <= tolerance,
+          what + ": " + std::to_string(value) + " vs " + std::to_string(reference));
+}
+
+} // namespace
+
+int main()
+{
+    using Traits = stabl::LgE60Traits;
+    constexpr std::size_t kCycles = 10;
+    constexpr double kStep = 1.0;
+
+    try {
+        stabl::BalancingSpread spread;
+        spread.soc0 = 0.5;
+        spread.soc_sigma = 0.05;
+        const std::vector<stabl::BalancingCell> cells = stabl::make_balancing_cells(
+            Traits::kNumCells, Traits::kCapacityAh, Traits::kR0 / static_cast<double>(Traits::kNumCells), spread);
+        const stabl::BalancingSimulator sim(stabl::balancing_pack<Traits>(), cells);
+
+        /* balancing_simulate's daily profile: 2 h charge / 10 h rest / 2 h discharge / 10 h rest at C/3 */
+        const double current = Traits::kCapacityAh / 3.0;
+        const stabl::CurrentProfile daily = {
+            {0.0, -current}, {7200.0, 0.0}, {43200.0, current}, {50400.0, 0.0}, {86400.0, 0.0}};
+
+        const stabl::BalancingReport event = sim.run(daily, kCycles);
+        const stabl::BalancingReport fixed = sim.run_fixed_step(daily, kCycles, kStep);
+
+        check(event.events * 20 < fixed.events, "event-driven run needs far fewer events");
+        check_near(event.simulated_time, fixed.simulated_time, 1e-6, "simulated time");
+        check(event.derating_cutoffs == fixed.derating_cutoffs, "derating cut-offs");
+        check_near(event.derated_time, fixed.derated_time, 1e-3 * fixed.derated_time, "derated time");
+        check_near(event.energy_wh(), fixed.energy_wh(), 1e-4 * fixed.energy_wh(), "balancing energy");
+        check(event.cells.size() == fixed.cells.size(), "cell count");
+
+        /* The reference detects each derating cut-off up to one step late, at the full current */
+        const double soc_tolerance = static_cast<double>(fixed.derating_cutoffs + 1) * kStep * current /
+                                     (Traits::kCapacityAh * 3600.0);
+        std::size_t balancing_cells = 0;
+        for (std::size_t i = 0; i < event.cells.size() && i < fixed.cells.size(); ++i) {
+            const stabl::BalancingCellStats& e = event.cells[i];
+            const stabl::BalancingCellStats& f = fixed.cells[i];
+            const std::string cell = "cell " + std::to_string(i);
+            check(e.starts == f.starts, cell + " balancing starts");
+            check(e.oscillations == f.oscillations, cell + " oscillations");
+            check_near(e.balancing_time, f.balancing_time, 2.0 * kStep * static_cast<double>(f.starts + 1),
+                       cell + " balancing time");
+            check_near(e.final_soc, f.final_soc, soc_tolerance, cell + " final SOC");
+            balancing_cells += e.starts > 0 ? 1 : 0;
+        }
+        check(balancing_cells > event.cells.size() / 2, "most cells balance in this setup");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "test_balancing: %s\n", e.what());
+        return 1;
+    }
+    if (g_failures != 0)
+        return 1;
+    std::printf("test_balancing: OK\n");
+    return 0;
+}
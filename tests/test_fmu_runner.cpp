@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        test_fmu_runner.cpp
+ * @brief       FmuRunner against the stub FMU in tests/stub_fmu
+ *
+ * Checks loading and instantiation, the step of every sample (also across the chunks of a
+ * binary trace), the replay_all fan-out and the error reporting. The expected outputs follow
+ * from the stub's formulas in stub_fmu.cpp.
+ *
+ * Build: built and registered with ctest by CMakeLists.txt
+ * Usage: test_fmu_runner <stub fmu dir> <input_data.csv> <scratch dir>
+ */
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "fmu_runner.h"
+#include "module_trace.h"
+#include "trace_file.h"
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++g_failures;
+    }
+}
+
+/* Outputs of the stub for @p trace, stepping every sample to the next one */
+std::vector<stabl::FmuOutputs> expected_outputs(const stabl::ModuleTrace& trace)
+{
+    std::vector<stabl::FmuOutputs> out(trace.size());
+    double soc = 50.0;
+    double step = 1.0;
+    for (std::size_t k = 0; k < trace.size(); ++k) {
+        if (k + 1 < trace.size())
+            step = trace.time[k + 1] - trace.time[k];
+        soc -= trace.i_mod_avg[k] * step / 36.0;
+        stabl::FmuOutputs& o = out[k];
+        o.soc = soc;
+        o.soc_conf = trace.time[k] + step;
+        o.soh = trace.i_mod_rms[k];
+        o.soh_conf = trace.u_bat[k];
+        for (std::size_t j = 0; j < stabl::FmuOutputs::kNumDerating; ++j)
+            o.i_mod_dr[j] = static_cast<double>(j) * trace.i_mod_avg[k];
+    }
+    return out;
+}
+
+bool equal(const stabl::FmuOutputs& a, const stabl::FmuOutputs& b)
+{
+    if (a.soc != b.soc || a.soc_conf != b.soc_conf || a.soh != b.soh || a.soh_conf != b.soh_conf)
+        return false;
+    for (std::size_t j = 0; j < stabl::FmuOutputs::kNumDerating; ++j) {
+        if (a.i_mod_dr[j] != b.i_mod_dr[j])
+            return false;
+    }
+    return true;
+}
+
+void check_replay(const stabl::FmuReplay& replay, const std::vector<stabl::FmuOutputs>& expected,
+                  const std::string& what)
+{
+    check(replay.error.empty(), what + ": unexpected error '" + replay.error + "'");
+    check(replay.outputs.size() == expected.size(), what + ": " + std::to_string(replay.outputs.size()) +
+                                                        " outputs, expected " + std::to_string(expected.size()));
+    for (std::size_t k = 0; k < replay.outputs.size() && k < expected.size(); ++k) {
+        if (!equal(replay.outputs[k], expected[k])) {
+            check(false, what + ": outputs differ at sample " + std::to_string(k));
+            break;
+        }
+    }
+}
+
+/* Write @p trace with small chunks so the replay crosses many chunk boundaries */
+void save_chunked(const std::string& path, const stabl::ModuleTrace& trace, std::size_t rows_per_chunk)
+{
+    stabl::TraceWriter writer(path, {"time", "i_mod_avg", "i_mod_rms", "u_bat"}, rows_per_chunk);
+    for (std::size_t k = 0; k < trace.size(); ++k) {
+        const double row[] = {trace.time[k], trace.i_mod_avg[k], trace.i_mod_rms[k], trace.u_bat[k]};
+        writer.append(row);
+    }
+    writer.close();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 4) {
+        std::fprintf(stderr, "Usage: test_fmu_runner <stub fmu dir> <input_data.csv> <scratch dir>\n");
+        return 2;
+    }
+    try {
+        const stabl::FmuRunner runner(argv[1]);
+        check(runner.model_identifier() == "StablModule_SOC_SOH_stub", "model identifier");
+
+        const stabl::ModuleTrace trace = stabl::load_module_trace_csv(argv[2]);
+        const std::vector<stabl::FmuOutputs> expected = expected_outputs(trace);
+        check_replay(runner.replay(trace, "csv"), expected, "CSV trace");
+
+        const std::string binary = std::string(argv[3]) + "/test_fmu_runner.trc";
+        save_chunked(binary, trace, 997);
+        const stabl::ModuleTraceSource source(binary);
+        check(source.num_chunks() > 1, "binary trace has several chunks");
+        check_replay(runner.replay(source, "binary"), expected, "chunked binary trace");
+
+        stabl::ModuleTrace one;
+        one.time = {trace.time[0]};
+        one.i_mod_avg = {trace.i_mod_avg[0]};
+        one.i_mod_rms = {trace.i_mod_rms[0]};
+        one.u_bat = {trace.u_bat[0]};
+        check_replay(runner.replay(one, "single"), expected_outputs(one), "single sample");
+        check_replay(runner.replay(stabl::ModuleTrace(), "empty"), {}, "empty trace");
+
+        const std::vector<stabl::ModuleTraceSource> sources = {source, stabl::ModuleTraceSource(trace), source,
+                                                               stabl::ModuleTraceSource(one), source};
+        const std::vector<stabl::FmuReplay> all = runner.replay_all(sources, 3);
+        check(all.size() == sources.size(), "replay_all returns one result per trace");
+        for (std::size_t i = 0; i < all.size(); ++i)
+            check_replay(all[i], i == 3 ? expected_outputs(one) : expected, "replay_all trace " + std::to_string(i));
+
+        const stabl::FmuReplay failed = runner.replay(trace, "trace_fail");
+        check(failed.outputs.empty(), "failed replay has no outputs");
+        check(failed.error.find("fmi3DoStep failed") == 0, "failed replay names the call: '" + failed.error + "'");
+        check(failed.error.find("forced failure") != std::string::npos,
+              "failed replay carries the FMU log: '" + failed.error + "'");
+
+        check_replay(runner.replay(trace, "trace_log"), expected, "logged errors without a failed call");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "test_fmu_runner: %s\n", e.what());
+        return 1;
+    }
+    if (g_failures != 0)
+        return 1;
+    std::printf("test_fmu_runner: OK\n");
+    return 0;
+}
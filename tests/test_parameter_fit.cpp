@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        test_parameter_fit.cpp
+ * @brief       ParameterFitter recovers known 2RC parameters from a synthetic PWM trace
+ *
+ * The trace is EcmSimulator's response to the 20 s ON / 10 s OFF step discharge, with R/C
+ * values that differ from the config so the fit cannot fall back on them. The initial SOC is
+ * fitted as well; a second fit with a single RC branch must not beat the true model.
+ *
+ * Build: built and registered with ctest by CMakeLists.txt
+ * Usage: test_parameter_fit <battery.config>
+ */
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "current_profile.h"
+#include "ecm_simulator.h"
+#include "module_trace.h"
+#include "parameter_fit.h"
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++g_failures;
+    }
+}
+
+void check_relative(double value, double reference, double tolerance, const char* what)
+{
+    check(std::fabs(value - reference) <= tolerance * std::fabs(reference),
+          std::string(what) + ": " + std::to_string(value) + " vs " + std::to_string(reference));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: test_parameter_fit <battery.config>\n");
+        return 2;
+    }
+    constexpr double kSoc0 = 0.9;
+
+    try {
+        const stabl::EcmParameters base = stabl::load_ecm_parameters(argv[1]);
+        stabl::EcmParameters truth = base;
+        truth.r0 = 0.004;
+        truth.r1 = 0.008;
+        truth.c1 = 2500.0;      /* tau1 = 20 s */
+        truth.r2 = 0.003;
+        truth.c2 = 400000.0;    /* tau2 = 1200 s */
+
+        stabl::ModuleTrace trace;
+        stabl::EcmSimulator sim(truth, kSoc0);
+        sim.run(stabl::generate_step_discharge_profile_pwm(truth), 1.0, [&](const stabl::EcmSample& s) {
+            trace.time.push_back(s.time);
+            trace.i_mod_avg.push_back(s.current);
+            trace.i_mod_rms.push_back(std::fabs(s.current));
+            trace.u_bat.push_back(s.voltage);
+        });
+
+        stabl::ParameterFitter fitter(base);
+        const stabl::FitResult fit = fitter.fit(trace);
+        check_relative(fit.params.r0, truth.r0, 0.01, "R0");
+        check_relative(fit.params.r1, truth.r1, 0.05, "R1");
+        check_relative(fit.params.r1 * fit.params.c1, truth.r1 * truth.c1, 0.05, "tau1");
+        check_relative(fit.params.r2, truth.r2, 0.05, "R2");
+        check_relative(fit.params.r2 * fit.params.c2, truth.r2 * truth.c2, 0.05, "tau2");
+        check(std::fabs(fit.soc0 - kSoc0) < 1e-3, "soc0: " + std::to_string(fit.soc0));
+        check(fit.rms_error < 1e-3, "rms error " + std::to_string(fit.rms_error) + " V");
+        check(fit.params.capacity_ah == base.capacity_ah, "capacity is taken from the config");
+
+        stabl::FitOptions one_rc;
+        one_rc.rc_branches = 1;
+        one_rc.soc0 = kSoc0;
+        const stabl::FitResult single = stabl::ParameterFitter(base, one_rc).fit(trace);
+        check(single.params.r2 == 0.0, "one RC branch keeps R2 = 0");
+        check(single.rms_error >= fit.rms_error, "one RC branch does not fit better than two");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "test_parameter_fit: %s\n", e.what());
+        return 1;
+    }
+    if (g_failures != 0)
+        return 1;
+    std::printf("test_parameter_fit: OK\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        test_trace_file.cpp
+ * @brief       Binary trace round trip of input_data.csv and chunk lookup
+ *
+ * Writes the trace with small chunks, with and without the time delta encoding and with
+ * timestamps the delta encoding cannot represent, maps it back and compares every value bit for
+ * bit. TraceFile::find_chunk() and the ranged iteration are checked against a linear search.
+ *
+ * Build: built and registered with ctest by CMakeLists.txt
+ * Usage: test_trace_file <input_data.csv> <scratch dir>
+ */
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "module_trace.h"
+#include "trace_file.h"
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++g_failures;
+    }
+}
+
+bool same_bits(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+bool same_trace(const stabl::ModuleTrace& a, const stabl::ModuleTrace& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        if (!same_bits(a.time[k], b.time[k]) || !same_bits(a.i_mod_avg[k], b.i_mod_avg[k]) ||
+            !same_bits(a.i_mod_rms[k], b.i_mod_rms[k]) || !same_bits(a.u_bat[k], b.u_bat[k]))
+            return false;
+    }
+    return true;
+}
+
+void save(const std::string& path, const stabl::ModuleTrace& trace, std::size_t rows_per_chunk, bool delta_time)
+{
+    stabl::TraceWriter writer(path, {"time", "i_mod_avg", "i_mod_rms", "u_bat"}, rows_per_chunk, delta_time);
+    for (std::size_t k = 0; k < trace.size(); ++k) {
+        const double row[] = {trace.time[k], trace.i_mod_avg[k], trace.i_mod_rms[k], trace.u_bat[k]};
+        writer.append(row);
+    }
+    writer.close();
+}
+
+/* The mapped file holds @p trace in chunks of @p rows_per_chunk rows, with consistent index entries */
+void check_file(const std::string& path, const stabl::ModuleTrace& trace, std::size_t rows_per_chunk,
+                const std::string& what)
+{
+    const stabl::TraceFile file(path);
+    check(file.num_rows() == trace.size(), what + ": row count");
+    check(file.num_columns() == 4 && file.column_index("u_bat") == 3 && file.column_index("soc") == 4,
+          what + ": columns");
+    check(file.num_chunks() == (trace.size() + rows_per_chunk - 1) / rows_per_chunk, what + ": chunk count");
+
+    std::vector<double> scratch;
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < file.num_chunks(); ++i) {
+        const stabl::trace_format::ChunkIndexEntry& info = file.chunk_info(i);
+        const stabl::TraceFile::Chunk chunk = file.chunk(i, scratch);
+        check(chunk.rows() == info.rows && info.offset % stabl::trace_format::kAlignment == 0,
+              what + ": index entry of chunk " + std::to_string(i));
+        check(same_bits(info.t_first, trace.time[first]) && same_bits(info.t_last, trace.time[first + info.rows - 1]),
+              what + ": time range of chunk " + std::to_string(i));
+        for (std::size_t k = 0; k < chunk.rows(); ++k) {
+            const std::size_t row = first + k;
+            if (!same_bits(chunk.time()[k], trace.time[row]) ||
+                !same_bits(chunk.column(1)[k], trace.i_mod_avg[row]) ||
+                !same_bits(chunk.column(2)[k], trace.i_mod_rms[row]) ||
+                !same_bits(chunk.column(3)[k], trace.u_bat[row])) {
+                check(false, what + ": values differ at row " + std::to_string(row));
+                break;
+            }
+        }
+        first += chunk.rows();
+    }
+    check(same_trace(stabl::load_module_trace(path), trace), what + ": load_module_trace");
+}
+
+/* find_chunk() and the chunk iteration by time agree with a linear search over the index */
+void check_find_chunk(const std::string& path, const stabl::ModuleTrace& trace)
+{
+    const stabl::TraceFile file(path);
+    const auto linear = [&](double t) {
+        std::size_t i = 0;
+        while (i < file.num_chunks() && file.chunk_info(i).t_last < t)
+            ++i;
+        return i;
+    };
+    std::vector<double> probes = {trace.time.front() - 1.0, trace.time.back(), trace.time.back() + 1.0};
+    for (std::size_t k = 0; k < trace.size(); ++k) {
+        probes.push_back(trace.time[k]);
+        if (k + 1 < trace.size())
+            probes.push_back(0.5 * (trace.time[k] + trace.time[k + 1]));
+    }
+    for (double t : probes) {
+        if (file.find_chunk(t) != linear(t)) {
+            check(false, "find_chunk(" + std::to_string(t) + ")");
+            break;
+        }
+    }
+    check(file.find_chunk(trace.time.back() + 1.0) == file.num_chunks(), "find_chunk past the end");
+
+    const double t_begin = file.chunk_info(2).t_first + 0.5;
+    const double t_end = file.chunk_info(5).t_first;
+    std::vector<std::size_t> rows;
+    file.for_each_chunk(t_begin, t_end, [&](const stabl::TraceFile::Chunk& c) { rows.push_back(c.rows()); });
+    check(rows.size() == 4, "for_each_chunk visits the chunks overlapping the range");
+}
+
+/* for_each_range() hands out exactly the requested rows, also across chunk boundaries */
+void check_ranges(const std::string& path, const stabl::ModuleTrace& trace, std::size_t rows_per_chunk)
+{
+    const stabl::ModuleTraceSource source(path);
+    const std::size_t n = trace.size();
+    const std::size_t bounds[][2] = {{0, n}, {0, 1}, {rows_per_chunk - 1, rows_per_chunk + 1},
+                                     {rows_per_chunk, 3 * rows_per_chunk}, {n / 3, n - 7}, {n - 1, n}, {5, 5}};
+    for (const auto& b : bounds) {
+        std::size_t next = b[0];
+        bool ok = true;
+        source.for_each_range(b[0], b[1], [&](std::size_t first, const stabl::ModuleTraceView& v) {
+            ok = ok && first == next && v.size() > 0;
+            for (std::size_t k = 0; k < v.size() && ok; ++k)
+                ok = same_bits(v.time[k], trace.time[first + k]) && same_bits(v.u_bat[k], trace.u_bat[first + k]);
+            next = first + v.size();
+        });
+        check(ok && next == (b[1] > b[0] ? b[1] : b[0]),
+              "for_each_range(" + std::to_string(b[0]) + ", " + std::to_string(b[1]) + ")");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: test_trace_file <input_data.csv> <scratch dir>\n");
+        return 2;
+    }
+    try {
+        const stabl::ModuleTrace trace = stabl::load_module_trace_csv(argv[1]);
+        check(trace.size() > 10000, "input trace is long enough for several chunks");
+        const std::string dir = argv[2];
+        constexpr std::size_t kRows = 1000;
+
+        const std::string delta = dir + "/test_trace_delta.trc";
+        save(delta, trace, kRows, true);
+        check_file(delta, trace, kRows, "delta time");
+        check_find_chunk(delta, trace);
+        check_ranges(delta, trace, kRows);
+
+        const std::string plain = dir + "/test_trace_plain.trc";
+        save(plain, trace, kRows, false);
+        check_file(plain, trace, kRows, "plain time");
+
+        check(std::filesystem::file_size(delta) < std::filesystem::file_size(plain), "delta time is smaller");
+
+        /* Timestamps off the 1 s grid fall back to plain doubles in the affected chunks */
+        stabl::ModuleTrace jittered = trace;
+        for (std::size_t k = 2500; k < 2600; k += 3)
+            jittered.time[k] += 1.0 / 3.0;
+        const std::string mixed = dir + "/test_trace_jittered.trc";
+        save(mixed, jittered, kRows, true);
+        check_file(mixed, jittered, kRows, "jittered time");
+        check_find_chunk(mixed, jittered);
+
+        const std::string whole = dir + "/test_trace_default.trc";
+        stabl::save_module_trace_binary(whole, trace);
+        check(same_trace(stabl::load_module_trace_binary(whole), trace), "save/load_module_trace_binary");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "test_trace_file: %s\n", e.what());
+        return 1;
+    }
+    if (g_failures != 0)
+        return 1;
+    std::printf("test_trace_file: OK\n");
+    return 0;
+}
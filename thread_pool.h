@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        thread_pool.h
+ * @brief       Minimal persistent thread pool for data-parallel loops
+ */
+#ifndef STABL_THREAD_POOL_H
+#define STABL_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stabl {
+
+/**
+ * @brief Fixed set of workers that split a [0, n) index range in equal chunks
+ *
+ * The calling thread takes the first chunk itself, so a pool of size 1 runs inline without
+ * any synchronisation. parallel_for() must not be called concurrently or recursively.
+ */
+class ThreadPool {
+public:
+    /** @p num_threads == 0 selects std::thread::hardware_concurrency(). */
+    explicit ThreadPool(std::size_t num_threads = 0)
+    {
+        if (num_threads == 0)
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 1; i < num_threads; ++i)
+            workers_.emplace_back([this, i] { worker(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& w : workers_)
+            w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const { return workers_.size() + 1; }
+
+    /** Call @p fn(begin, end) on disjoint chunks covering [0, @p n) and wait for all of them. */
+    void parallel_for(std::size_t n, const std::function<void(std::size_t, std::size_t)>& fn)
+    {
+        if (n == 0)
+            return;
+        if (workers_.empty() || n == 1) {
+            fn(0, n);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &fn;
+            count_ = n;
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        const auto range = chunk(0);
+        if (range.first < range.second)
+            fn(range.first, range.second);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    std::pair<std::size_t, std::size_t> chunk(std::size_t index) const
+    {
+        const std::size_t parts = size();
+        const std::size_t base = count_ / parts;
+        const std::size_t extra = count_ % parts;
+        const std::size_t begin = index * base + std::min(index, extra);
+        return {begin, begin + base + (index < extra ? 1 : 0)};
+    }
+
+    void worker(std::size_t index)
+    {
+        std::size_t seen = 0;
+        for (;;) {
+            const std::function<void(std::size_t, std::size_t)>* task;
+            std::pair<std::size_t, std::size_t> range;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+                task = task_;
+                range = chunk(index);
+            }
+            if (range.first < range.second)
+                (*task)(range.first, range.second);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t, std::size_t)>* task_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t pending_ = 0;
+    std::size_t generation_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace stabl
+
+#endif /* STABL_THREAD_POOL_H */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        trace_convert.cpp
+ * @brief       Convert CSV traces to the binary trace format and query binary traces
+ *
+ * Build:  g++ -O2 -std=c++17 trace_convert.cpp trace_file.cpp module_trace.cpp -o trace_convert
+ *
+ * Usage:  trace_convert <in.csv> <out.trc> [--chunk-rows n] [--no-delta]
+ *         trace_convert --info <file.trc>
+ *         trace_convert --to-csv <file.trc> [--from t0] [--to t1]
+ *
+ * Any CSV whose header names a "time" column followed by numeric columns converts; time is
+ * moved to the front. --to-csv prints the rows in [t0, t1], reading only the chunks that
+ * overlap that range.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "csv_reader.h"
+#include "trace_file.h"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: trace_convert <in.csv> <out.trc> [--chunk-rows n] [--no-delta]\n"
+                 "       trace_convert --info <file.trc>\n"
+                 "       trace_convert --to-csv <file.trc> [--from t0] [--to t1]\n");
+}
+
+int convert(const std::string& in_path, const std::string& out_path, std::size_t chunk_rows, bool delta)
+{
+    const auto t_start = std::chrono::steady_clock::now();
+    const stabl::MappedFile csv(in_path, true);
+    stabl::CsvReader reader(csv.begin(), csv.end(), in_path);
+
+    /* "time" becomes column 0 of the output, the others follow in their order */
+    const std::vector<std::string>& names = reader.columns();
+    const std::size_t time_col = reader.column_index("time");
+    if (time_col == names.size())
+        throw std::runtime_error("'" + in_path + "' has no 'time' column");
+    std::vector<std::string> columns{"time"};
+    std::vector<std::size_t> order{time_col};
+    for (std::size_t c = 0; c < names.size(); ++c) {
+        if (c != time_col) {
+            columns.push_back(names[c]);
+            order.push_back(c);
+        }
+    }
+    reader.select(order);
+
+    stabl::TraceWriter writer(out_path, columns, chunk_rows, delta);
+    std::vector<double> row(columns.size());
+    std::size_t rows = 0;
+    while (reader.next(row.data())) {
+        writer.append(row.data());
+        ++rows;
+    }
+    writer.close();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    std::printf("%zu rows x %zu columns converted in %.3f s\n", rows, columns.size(), wall);
+    return 0;
+}
+
+int info(const std::string& path)
+{
+    const stabl::TraceFile file(path);
+    std::printf("%zu rows, %zu columns, %zu chunks\n", file.num_rows(), file.num_columns(), file.num_chunks());
+    for (std::size_t i = 0; i < file.num_chunks(); ++i) {
+        const auto& e = file.chunk_info(i);
+        std::printf("chunk %zu: %llu rows, t = [%.17g, %.17g]\n", i, static_cast<unsigned long long>(e.rows),
+                    e.t_first, e.t_last);
+        for (std::size_t c = 1; c < file.num_columns(); ++c) {
+            const auto& s = file.column_stats(i, c);
+            std::printf("    %-16s min %.17g max %.17g\n", file.column_name(c).c_str(), s.min, s.max);
+        }
+    }
+    return 0;
+}
+
+int to_csv(const std::string& path, double t0, double t1)
+{
+    const stabl::TraceFile file(path);
+    for (std::size_t c = 0; c < file.num_columns(); ++c)
+        std::printf("%s%s", c ? "," : "", file.column_name(c).c_str());
+    std::putchar('\n');
+    file.for_each_chunk(t0, t1, [&](const stabl::TraceFile::Chunk& chunk) {
+        for (std::size_t k = 0; k < chunk.rows(); ++k) {
+            const double t = chunk.time()[k];
+            if (t < t0 || t > t1)
+                continue;
+            std::printf("%.17g", t);
+            for (std::size_t c = 1; c < file.num_columns(); ++c)
+                std::printf(",%.17g", chunk.column(c)[k]);
+            std::putchar('\n');
+        }
+    });
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+
+    try {
+        if (!std::strcmp(argv[1], "--info"))
+            return info(argv[2]);
+
+        if (!std::strcmp(argv[1], "--to-csv")) {
+            double t0 = -std::numeric_limits<double>::infinity();
+            double t1 = std::numeric_limits<double>::infinity();
+            for (int i = 3; i < argc; ++i) {
+                if (!std::strcmp(argv[i], "--from") && i + 1 < argc) {
+                    t0 = std::atof(argv[++i]);
+                } else if (!std::strcmp(argv[i], "--to") && i + 1 < argc) {
+                    t1 = std::atof(argv[++i]);
+                } else {
+                    usage();
+                    return 2;
+                }
+            }
+            return to_csv(argv[2], t0, t1);
+        }
+
+        std::size_t chunk_rows = 4096;
+        bool delta = true;
+        for (int i = 3; i < argc; ++i) {
+            if (!std::strcmp(argv[i], "--chunk-rows") && i + 1 < argc) {
+                chunk_rows = std::strtoul(argv[++i], nullptr, 10);
+            } else if (!std::strcmp(argv[i], "--no-delta")) {
+                delta = false;
+            } else {
+                usage();
+                return 2;
+            }
+        }
+        return convert(argv[1], argv[2], chunk_rows, delta);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "trace_convert: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        trace_file.cpp
+ * @brief       Memory-mapped columnar binary trace format
+ */
+#include "trace_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace stabl {
+
+using namespace trace_format;
+
+namespace {
+
+std::uint64_t align_up(std::uint64_t offset)
+{
+    return (offset + kAlignment - 1) & ~static_cast<std::uint64_t>(kAlignment - 1);
+}
+
+std::size_t time_block_size(std::uint32_t encoding, std::size_t rows)
+{
+    return rows * (encoding == kTimeDelta ? sizeof(std::int32_t) : sizeof(double));
+}
+
+/*
+ * Quantum for the delta encoding of @p t, or 0 if it would not reproduce every timestamp
+ * bit for bit. The smallest positive step is tried as quantum.
+ */
+double delta_quantum(const std::vector<double>& t)
+{
+    double quantum = std::numeric_limits<double>::infinity();
+    for (std::size_t k = 1; k < t.size(); ++k)
+        if (t[k] > t[k - 1])
+            quantum = std::min(quantum, t[k] - t[k - 1]);
+    if (!std::isfinite(quantum))
+        quantum = 1.0;
+
+    std::int64_t steps = 0;
+    for (std::size_t k = 1; k < t.size(); ++k) {
+        const double d = std::round((t[k] - t[k - 1]) / quantum);
+        if (d > std::numeric_limits<std::int32_t>::max())
+            return 0.0;
+        steps += static_cast<std::int64_t>(d);
+        if (t[0] + quantum * static_cast<double>(steps) != t[k])
+            return 0.0;
+    }
+    return quantum;
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(const std::string& path, const std::vector<std::string>& columns,
+                         std::size_t rows_per_chunk, bool delta_time)
+    : file_(nullptr),
+      num_columns_(columns.size()),
+      rows_per_chunk_(rows_per_chunk),
+      delta_time_(delta_time),
+      chunk_(columns.size())
+{
+    if (columns.empty() || columns[0] != "time")
+        throw std::runtime_error("the first trace column must be 'time'");
+    if (rows_per_chunk == 0 || rows_per_chunk > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("invalid rows_per_chunk");
+    for (const auto& name : columns)
+        if (name.empty() || name.size() >= kColumnNameSize)
+            throw std::runtime_error("trace column name '" + name + "' must be 1.." +
+                                     std::to_string(kColumnNameSize - 1) + " characters");
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr)
+        throw std::runtime_error("cannot create trace '" + path + "'");
+
+    FileHeader header{};
+    write(&header, sizeof(header));     /* placeholder, rewritten by close() */
+    for (const auto& name : columns) {
+        char field[kColumnNameSize] = {};
+        std::memcpy(field, name.data(), name.size());
+        write(field, sizeof(field));
+    }
+    pad();
+    for (auto& c : chunk_)
+        c.reserve(rows_per_chunk_);
+}
+
+TraceWriter::~TraceWriter()
+{
+    if (file_ == nullptr)
+        return;
+    try {
+        close();
+    } catch (...) {
+        /* Destructors must not throw; call close() to see errors */
+    }
+}
+
+void TraceWriter::write(const void* data, std::size_t size)
+{
+    if (size != 0 && std::fwrite(data, 1, size, file_) != size)
+        throw std::runtime_error("write error on trace file");
+    offset_ += size;
+}
+
+void TraceWriter::pad()
+{
+    static const unsigned char zeros[kAlignment] = {};
+    write(zeros, align_up(offset_) - offset_);
+}
+
+void TraceWriter::append(const double* row)
+{
+    std::vector<double>& time = chunk_[0];
+    const double last = !time.empty() ? time.back() : (index_.empty() ? row[0] : index_.back().t_last);
+    if (row[0] < last)
+        throw std::runtime_error("trace time must not decrease");
+    for (std::size_t c = 0; c < num_columns_; ++c)
+        chunk_[c].push_back(row[c]);
+    if (time.size() == rows_per_chunk_)
+        flush_chunk();
+}
+
+void TraceWriter::flush_chunk()
+{
+    const std::vector<double>& time = chunk_[0];
+    const std::size_t rows = time.size();
+    if (rows == 0)
+        return;
+
+    ChunkHeader header{};
+    header.rows = static_cast<std::uint32_t>(rows);
+    header.time_base = time.front();
+    header.time_quantum = delta_time_ ? delta_quantum(time) : 0.0;
+    header.time_encoding = header.time_quantum > 0.0 ? kTimeDelta : kTimeRaw;
+
+    index_.push_back(ChunkIndexEntry{offset_, rows, time.front(), time.back()});
+    write(&header, sizeof(header));
+
+    for (const auto& column : chunk_) {
+        const auto mm = std::minmax_element(column.begin(), column.end());
+        const ColumnStats stats{*mm.first, *mm.second};
+        write(&stats, sizeof(stats));
+    }
+    pad();
+
+    if (header.time_encoding == kTimeDelta) {
+        std::vector<std::int32_t> deltas(rows, 0);
+        for (std::size_t k = 1; k < rows; ++k)
+            deltas[k] = static_cast<std::int32_t>(std::round((time[k] - time[k - 1]) / header.time_quantum));
+        write(deltas.data(), deltas.size() * sizeof(std::int32_t));
+    } else {
+        write(time.data(), rows * sizeof(double));
+    }
+    pad();
+
+    for (std::size_t c = 1; c < num_columns_; ++c) {
+        write(chunk_[c].data(), rows * sizeof(double));
+        pad();
+    }
+
+    num_rows_ += rows;
+    for (auto& column : chunk_)
+        column.clear();
+}
+
+void TraceWriter::close()
+{
+    if (file_ == nullptr)
+        return;
+    flush_chunk();
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.num_columns = static_cast<std::uint32_t>(num_columns_);
+    header.num_rows = num_rows_;
+    header.rows_per_chunk = static_cast<std::uint32_t>(rows_per_chunk_);
+    header.num_chunks = static_cast<std::uint32_t>(index_.size());
+    header.index_offset = offset_;
+    write(index_.data(), index_.size() * sizeof(ChunkIndexEntry));
+
+    const bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+                    std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    const bool closed = std::fclose(file_) == 0;
+    file_ = nullptr;
+    if (!ok || !closed)
+        throw std::runtime_error("write error on trace file");
+}
+
+MappedFile::MappedFile(const std::string& path, bool sequential)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open '" + path + "'");
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat '" + path + "'");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map '" + path + "'");
+        }
+        data_ = static_cast<const unsigned char*>(map);
+        if (sequential)
+            ::madvise(map, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_ != nullptr)
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+}
+
+TraceFile::TraceFile(const std::string& path) : map_(path), data_(map_.data()), size_(map_.size())
+{
+    if (size_ < sizeof(FileHeader))
+        throw std::runtime_error("'" + path + "' is not a binary trace");
+    header_ = reinterpret_cast<const FileHeader*>(data_);
+
+    const auto fail = [&](const char* why) {
+        throw std::runtime_error("'" + path + "': " + why);
+    };
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0)
+        fail("not a binary trace");
+    if (header_->version != kVersion)
+        fail("unsupported trace version");
+    /* All checks subtract from size_, so crafted offsets and counts cannot wrap around */
+    const auto fits = [&](std::uint64_t offset, std::uint64_t count, std::uint64_t size) {
+        return offset <= size_ && (size == 0 || count <= (size_ - offset) / size);
+    };
+    if (header_->num_columns == 0 || !fits(sizeof(FileHeader), header_->num_columns, kColumnNameSize))
+        fail("truncated trace");
+    if (header_->index_offset % kAlignment != 0)
+        fail("misaligned chunk index");
+    if (!fits(header_->index_offset, header_->num_chunks, sizeof(ChunkIndexEntry)))
+        fail("truncated trace");
+
+    const char* names = reinterpret_cast<const char*>(data_ + sizeof(FileHeader));
+    for (std::size_t c = 0; c < header_->num_columns; ++c)
+        names_.emplace_back(names + c * kColumnNameSize, strnlen(names + c * kColumnNameSize, kColumnNameSize));
+    index_ = reinterpret_cast<const ChunkIndexEntry*>(data_ + header_->index_offset);
+
+    /* Validate chunk extents once, so chunk() can trust them */
+    std::uint64_t rows = 0;
+    for (std::size_t i = 0; i < num_chunks(); ++i) {
+        const std::uint64_t offset = index_[i].offset;
+        if (offset % kAlignment != 0)
+            fail("misaligned chunk");
+        if (!fits(offset, 1, sizeof(ChunkHeader) + num_columns() * sizeof(ColumnStats)))
+            fail("truncated chunk");
+        const auto* ch = reinterpret_cast<const ChunkHeader*>(data_ + offset);
+        if (ch->rows != index_[i].rows || (ch->time_encoding != kTimeRaw && ch->time_encoding != kTimeDelta))
+            fail("corrupt chunk header");
+        /* rows < 2^32 and num_columns < size_ / kColumnNameSize, so the block sizes cannot overflow */
+        std::uint64_t end = align_up(offset + sizeof(ChunkHeader) + num_columns() * sizeof(ColumnStats));
+        if (!fits(end, 1, time_block_size(ch->time_encoding, ch->rows)))
+            fail("truncated chunk");
+        end = align_up(end + time_block_size(ch->time_encoding, ch->rows));
+        if (!fits(end, num_columns() - 1, align_up(ch->rows * sizeof(double))))
+            fail("truncated chunk");
+        rows += ch->rows;
+    }
+    if (rows != num_rows())
+        fail("row count does not match the chunks");
+}
+
+std::size_t TraceFile::column_index(const std::string& name) const
+{
+    return static_cast<std::size_t>(std::find(names_.begin(), names_.end(), name) - names_.begin());
+}
+
+const ColumnStats& TraceFile::column_stats(std::size_t chunk, std::size_t c) const
+{
+    const auto* stats = reinterpret_cast<const ColumnStats*>(data_ + index_[chunk].offset + sizeof(ChunkHeader));
+    return stats[c];
+}
+
+TraceFile::Chunk TraceFile::chunk(std::size_t i, std::vector<double>& time_scratch) const
+{
+    const std::uint64_t base = index_[i].offset;
+    const auto* header = reinterpret_cast<const ChunkHeader*>(data_ + base);
+    const std::size_t rows = header->rows;
+
+    Chunk chunk;
+    chunk.rows_ = rows;
+    chunk.columns_.resize(num_columns());
+
+    std::uint64_t offset = align_up(base + sizeof(ChunkHeader) + num_columns() * sizeof(ColumnStats));
+    if (header->time_encoding == kTimeDelta) {
+        const auto* deltas = reinterpret_cast<const std::int32_t*>(data_ + offset);
+        time_scratch.resize(rows);
+        std::int64_t steps = 0;
+        for (std::size_t k = 0; k < rows; ++k) {
+            steps += deltas[k];
+            time_scratch[k] = header->time_base + header->time_quantum * static_cast<double>(steps);
+        }
+        chunk.columns_[0] = time_scratch.data();
+    } else {
+        chunk.columns_[0] = reinterpret_cast<const double*>(data_ + offset);
+    }
+    offset = align_up(offset + time_block_size(header->time_encoding, rows));
+
+    for (std::size_t c = 1; c < num_columns(); ++c) {
+        chunk.columns_[c] = reinterpret_cast<const double*>(data_ + offset);
+        offset += align_up(rows * sizeof(double));
+    }
+    return chunk;
+}
+
+std::size_t TraceFile::find_chunk(double t) const
+{
+    const auto* end = index_ + num_chunks();
+    return static_cast<std::size_t>(
+        std::lower_bound(index_, end, t, [](const ChunkIndexEntry& e, double v) { return e.t_last < v; }) - index_);
+}
+
+void save_module_trace_binary(const std::string& path, const ModuleTrace& trace)
+{
+    TraceWriter writer(path, {"time", "i_mod_avg", "i_mod_rms", "u_bat"});
+    for (std::size_t k = 0; k < trace.size(); ++k) {
+        const double row[] = {trace.time[k], trace.i_mod_avg[k], trace.i_mod_rms[k], trace.u_bat[k]};
+        writer.append(row);
+    }
+    writer.close();
+}
+
+namespace {
+
+/* Columns i_mod_avg, i_mod_rms, u_bat of @p file */
+void module_columns(const TraceFile& file, const std::string& path, std::size_t (&columns)[3])
+{
+    const char* names[] = {"i_mod_avg", "i_mod_rms", "u_bat"};
+    for (std::size_t c = 0; c < 3; ++c) {
+        columns[c] = file.column_index(names[c]);
+        if (columns[c] == file.num_columns())
+            throw std::runtime_error("trace '" + path + "' has no column '" + names[c] + "'");
+    }
+}
+
+} // namespace
+
+ModuleTraceSource::ModuleTraceSource(const std::string& path)
+{
+    if (is_binary_trace(path)) {
+        file_ = std::make_shared<const TraceFile>(path);
+        module_columns(*file_, path, columns_);
+        rows_ = file_->num_rows();
+    } else {
+        parsed_ = std::make_shared<const ModuleTrace>(load_module_trace_csv(path));
+        trace_ = parsed_.get();
+        rows_ = trace_->size();
+    }
+}
+
+ModuleTraceSource::ModuleTraceSource(const ModuleTrace& trace) : trace_(&trace), rows_(trace.size()) {}
+
+ModuleTraceView ModuleTraceSource::chunk(std::size_t i, std::vector<double>& time_scratch) const
+{
+    if (!file_)
+        return trace_->view();
+    const TraceFile::Chunk c = file_->chunk(i, time_scratch);
+    return {c.rows(), c.time(), c.column(columns_[0]), c.column(columns_[1]), c.column(columns_[2])};
+}
+
+ModuleTrace load_module_trace_binary(const std::string& path)
+{
+    const TraceFile file(path);
+    std::size_t columns[3];
+    module_columns(file, path, columns);
+
+    ModuleTrace trace;
+    trace.reserve(file.num_rows());
+    std::vector<double> scratch;
+    for (std::size_t i = 0; i < file.num_chunks(); ++i) {
+        const TraceFile::Chunk chunk = file.chunk(i, scratch);
+        const std::size_t n = chunk.rows();
+        trace.time.insert(trace.time.end(), chunk.time(), chunk.time() + n);
+        trace.i_mod_avg.insert(trace.i_mod_avg.end(), chunk.column(columns[0]), chunk.column(columns[0]) + n);
+        trace.i_mod_rms.insert(trace.i_mod_rms.end(), chunk.column(columns[1]), chunk.column(columns[1]) + n);
+        trace.u_bat.insert(trace.u_bat.end(), chunk.column(columns[2]), chunk.column(columns[2]) + n);
+    }
+    return trace;
+}
+
+bool is_binary_trace(const std::string& path)
+{
+    char magic[sizeof(kMagic)] = {};
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (f == nullptr)
+        return false;
+    const bool ok = std::fread(magic, 1, sizeof(magic), f) == sizeof(magic);
+    std::fclose(f);
+    return ok && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+} // namespace stabl
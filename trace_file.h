@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        trace_file.h
+ * @brief       Memory-mapped columnar binary trace format
+ *
+ * Replaces text CSV for long module logs. A file holds any number of float64 columns, the
+ * first one always "time", split into chunks of up to rows_per_chunk rows:
+ *
+ *     FileHeader | ColumnName[num_columns] | Chunk... | ChunkIndexEntry[num_chunks]
+ *     Chunk = ChunkHeader | ColumnStats[num_columns] | time block | column blocks...
+ *
+ * Every block starts on a 64 byte boundary, so value columns are used in place from the
+ * mapping (no parsing, no copy) and are aligned for SIMD loads. The time block of a chunk is
+ * either raw float64 or, when every timestamp is exactly time_base + k * quantum, int32 deltas
+ * in units of the quantum (a quarter of the size for 1 Hz logs); the writer picks per chunk and
+ * falls back to raw whenever the delta form would not be lossless. The index at the end of the
+ * file carries each chunk's time range, so time-range queries binary-search it instead of
+ * scanning. All values are little endian.
+ */
+#ifndef STABL_TRACE_FILE_H
+#define STABL_TRACE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "module_trace.h"
+
+namespace stabl {
+
+namespace trace_format {
+
+constexpr char kMagic[8] = {'S', 'T', 'B', 'L', 'T', 'R', 'C', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kAlignment = 64;
+constexpr std::size_t kColumnNameSize = 32;
+
+enum TimeEncoding : std::uint32_t {
+    kTimeRaw = 0,           /**< float64 per row */
+    kTimeDelta = 1,         /**< int32 delta to the previous row, in units of time_quantum */
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_columns;
+    std::uint64_t num_rows;
+    std::uint32_t rows_per_chunk;
+    std::uint32_t num_chunks;
+    std::uint64_t index_offset;     /**< File offset of the ChunkIndexEntry array */
+    std::uint8_t reserved[24];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+
+struct ChunkHeader {
+    std::uint32_t rows;
+    std::uint32_t time_encoding;
+    double time_base;               /**< First timestamp; delta encoding starts from here */
+    double time_quantum;            /**< Unit of the int32 deltas */
+    std::uint8_t reserved[40];
+};
+static_assert(sizeof(ChunkHeader) == 64, "ChunkHeader layout");
+
+struct ColumnStats {
+    double min;
+    double max;
+};
+
+struct ChunkIndexEntry {
+    std::uint64_t offset;           /**< File offset of the ChunkHeader */
+    std::uint64_t rows;
+    double t_first;
+    double t_last;
+};
+
+} // namespace trace_format
+
+/** Read-only mapping of a whole file, used by the binary and the CSV trace readers. */
+class MappedFile {
+public:
+    /**
+     * @brief Map @p path; an empty file maps to an empty range
+     * @param sequential  Hint the kernel that the file is read front to back once
+     *
+     * Throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path, bool sequential = false);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const char* begin() const { return reinterpret_cast<const char*>(data_); }
+    const char* end() const { return begin() + size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Streaming writer
+ *
+ * Rows are buffered one chunk at a time, so memory use is independent of the trace length.
+ * Throws std::runtime_error on I/O errors.
+ */
+class TraceWriter {
+public:
+    /**
+     * @param columns           Column names, the first must be "time"
+     * @param rows_per_chunk    Chunk size; 4096 rows of 1 Hz data is a bit over an hour
+     * @param delta_time        Try the int32 delta encoding for the time column
+     */
+    TraceWriter(const std::string& path, const std::vector<std::string>& columns,
+                std::size_t rows_per_chunk = 4096, bool delta_time = true);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /** Append one row of num_columns values, time first; time must not decrease. */
+    void append(const double* row);
+
+    /** Flush the last chunk, write the index and close. Called by the destructor if needed. */
+    void close();
+
+private:
+    void flush_chunk();
+    void write(const void* data, std::size_t size);
+    void pad();
+
+    std::FILE* file_;
+    std::size_t num_columns_;
+    std::size_t rows_per_chunk_;
+    bool delta_time_;
+    std::uint64_t offset_ = 0;
+    std::uint64_t num_rows_ = 0;
+    std::vector<std::vector<double>> chunk_;        /**< Buffered columns of the open chunk */
+    std::vector<trace_format::ChunkIndexEntry> index_;
+};
+
+/** Read-only view of a trace file mapped into memory. */
+class TraceFile {
+public:
+    /** A decoded chunk; value columns point into the mapping, time may point into scratch. */
+    class Chunk {
+    public:
+        std::size_t rows() const { return rows_; }
+        const double* time() const { return columns_[0]; }
+        const double* column(std::size_t c) const { return columns_[c]; }
+
+    private:
+        friend class TraceFile;
+        std::size_t rows_ = 0;
+        std::vector<const double*> columns_;
+    };
+
+    /** Map @p path. Throws std::runtime_error if it cannot be opened or is not a trace file. */
+    explicit TraceFile(const std::string& path);
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    std::size_t num_rows() const { return static_cast<std::size_t>(header_->num_rows); }
+    std::size_t num_columns() const { return header_->num_columns; }
+    std::size_t num_chunks() const { return header_->num_chunks; }
+    const std::string& column_name(std::size_t c) const { return names_[c]; }
+    /** Index of the column called @p name, or num_columns() if there is none. */
+    std::size_t column_index(const std::string& name) const;
+
+    const trace_format::ChunkIndexEntry& chunk_info(std::size_t i) const { return index_[i]; }
+    const trace_format::ColumnStats& column_stats(std::size_t chunk, std::size_t c) const;
+
+    /**
+     * @brief Decode chunk @p i
+     *
+     * Delta-encoded timestamps are expanded into @p time_scratch, which must outlive the use
+     * of the returned chunk; all other columns are used in place.
+     */
+    Chunk chunk(std::size_t i, std::vector<double>& time_scratch) const;
+
+    /** First chunk whose time range ends at or after @p t, num_chunks() if none. */
+    std::size_t find_chunk(double t) const;
+
+    /**
+     * @brief Call @p fn(const Chunk&) for every chunk overlapping [@p t_begin, @p t_end]
+     *
+     * Whole chunks are passed; rows outside the range at the edges are left to the caller.
+     */
+    template <typename F>
+    void for_each_chunk(double t_begin, double t_end, F&& fn) const
+    {
+        std::vector<double> scratch;
+        for (std::size_t i = find_chunk(t_begin); i < num_chunks() && index_[i].t_first <= t_end; ++i)
+            fn(chunk(i, scratch));
+    }
+
+private:
+    MappedFile map_;
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+    const trace_format::FileHeader* header_ = nullptr;
+    const trace_format::ChunkIndexEntry* index_ = nullptr;
+    std::vector<std::string> names_;
+};
+
+/**
+ * @brief A module trace opened for replay, handed out chunk by chunk
+ *
+ * Binary traces stay mapped: every chunk is a ModuleTraceView whose value columns point into
+ * the mapping, so replays stream the file without copying it. CSV traces are parsed once and
+ * are a single chunk. Copies share the mapping or the parsed trace.
+ */
+class ModuleTraceSource {
+public:
+    /** Open @p path in either format, detected by content. Throws std::runtime_error. */
+    explicit ModuleTraceSource(const std::string& path);
+    /** View @p trace as a single chunk; the trace must outlive the source and its copies. */
+    explicit ModuleTraceSource(const ModuleTrace& trace);
+
+    std::size_t size() const { return rows_; }
+    std::size_t num_chunks() const { return file_ ? file_->num_chunks() : 1; }
+    std::size_t chunk_rows(std::size_t i) const
+    {
+        return file_ ? static_cast<std::size_t>(file_->chunk_info(i).rows) : rows_;
+    }
+
+    /** Chunk @p i; delta-encoded timestamps are expanded into @p time_scratch (see TraceFile::chunk()). */
+    ModuleTraceView chunk(std::size_t i, std::vector<double>& time_scratch) const;
+
+    /** Call @p fn(const ModuleTraceView&) for every chunk in time order. */
+    template <typename F>
+    void for_each_chunk(F&& fn) const
+    {
+        std::vector<double> scratch;
+        for (std::size_t i = 0; i < num_chunks(); ++i)
+            fn(chunk(i, scratch));
+    }
+
+    /**
+     * @brief Call @p fn(first, const ModuleTraceView&) for the rows [@p begin, @p end)
+     *
+     * The rows are passed in pieces cut at chunk boundaries; first is the trace row of the
+     * first sample of a piece. Chunks outside the range are not decoded, so a replay can be
+     * split over threads by rows.
+     */
+    template <typename F>
+    void for_each_range(std::size_t begin, std::size_t end, F&& fn) const
+    {
+        if (begin >= end)
+            return;
+        std::vector<double> scratch;
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < num_chunks() && first < end; ++i) {
+            const std::size_t rows = chunk_rows(i);
+            if (first + rows > begin) {
+                const std::size_t lo = begin > first ? begin - first : 0;
+                const std::size_t hi = end - first < rows ? end - first : rows;
+                fn(first + lo, chunk(i, scratch).slice(lo, hi));
+            }
+            first += rows;
+        }
+    }
+
+private:
+    std::shared_ptr<const TraceFile> file_;
+    std::size_t columns_[3] = {};           /**< i_mod_avg, i_mod_rms, u_bat in file_ */
+    std::shared_ptr<const ModuleTrace> parsed_;
+    const ModuleTrace* trace_ = nullptr;    /**< CSV or borrowed trace */
+    std::size_t rows_ = 0;
+};
+
+/** Write a ModuleTrace as a binary trace with columns time, i_mod_avg, i_mod_rms, u_bat. */
+void save_module_trace_binary(const std::string& path, const ModuleTrace& trace);
+
+/** Read a binary trace that has (at least) the ModuleTrace columns into memory; replays stream a ModuleTraceSource. */
+ModuleTrace load_module_trace_binary(const std::string& path);
+
+/** True if @p path starts with the binary trace magic. */
+bool is_binary_trace(const std::string& path);
+
+} // namespace stabl
+
+#endif /* STABL_TRACE_FILE_H */
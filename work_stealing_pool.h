@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2025 STABL Energy GmbH
+ */
+
+/**
+ * @file        work_stealing_pool.h
+ * @brief       Persistent thread pool for many independent tasks of uneven cost
+ */
+#ifndef STABL_WORK_STEALING_POOL_H
+#define STABL_WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stabl {
+
+/**
+ * @brief Runs task indices [0, n) on a fixed set of workers with range stealing
+ *
+ * Every worker starts with an equal contiguous share of the indices and takes them one by one
+ * from the front. A worker that runs dry steals the back half of the largest remaining share of
+ * another worker, so traces of different length or candidates of different cost still keep all
+ * cores busy until the end. Unlike ThreadPool the task callback also gets the worker index, which
+ * lets callers keep preallocated per-thread state. The calling thread is worker 0. run() must
+ * not be called concurrently or recursively.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(std::size_t task, std::size_t worker)>;
+
+    /** @p num_threads == 0 selects std::thread::hardware_concurrency(). */
+    explicit WorkStealingPool(std::size_t num_threads = 0)
+    {
+        if (num_threads == 0)
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        slots_.reset(new Slot[num_threads]);
+        for (std::size_t i = 1; i < num_threads; ++i)
+            workers_.emplace_back([this, i] { worker(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& w : workers_)
+            w.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    std::size_t size() const { return workers_.size() + 1; }
+
+    /** Call @p fn(task, worker) once for every task in [0, @p n) and wait for all of them. */
+    void run(std::size_t n, const Task& fn)
+    {
+        if (n == 0)
+            return;
+        if (workers_.empty()) {
+            for (std::size_t t = 0; t < n; ++t)
+                fn(t, 0);
+            return;
+        }
+
+        const std::size_t parts = size();
+        for (std::size_t i = 0; i < parts; ++i) {
+            std::lock_guard<std::mutex> lock(slots_[i].mutex);
+            slots_[i].begin = n * i / parts;
+            slots_[i].end = n * (i + 1) / parts;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &fn;
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        drain(0, fn);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    /** Remaining task range of one worker; own on a cache line so workers do not contend. */
+    struct alignas(64) Slot {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    bool pop(std::size_t self, std::size_t& task)
+    {
+        std::lock_guard<std::mutex> lock(slots_[self].mutex);
+        if (slots_[self].begin >= slots_[self].end)
+            return false;
+        task = slots_[self].begin++;
+        return true;
+    }
+
+    /* Move the back half of the fullest other range to @p self; false once all are empty */
+    bool steal(std::size_t self)
+    {
+        const std::size_t parts = size();
+        for (;;) {
+            std::size_t victim = parts;
+            std::size_t most = 0;
+            for (std::size_t i = 0; i < parts; ++i) {
+                if (i == self)
+                    continue;
+                std::lock_guard<std::mutex> lock(slots_[i].mutex);
+                const std::size_t left = slots_[i].end - std::min(slots_[i].begin, slots_[i].end);
+                if (left > most) {
+                    most = left;
+                    victim = i;
+                }
+            }
+            if (victim == parts)
+                return false;
+
+            std::size_t begin;
+            std::size_t end;
+            {
+                std::lock_guard<std::mutex> lock(slots_[victim].mutex);
+                if (slots_[victim].begin >= slots_[victim].end)
+                    continue; /* emptied meanwhile, look again */
+                const std::size_t take = (slots_[victim].end - slots_[victim].begin + 1) / 2;
+                end = slots_[victim].end;
+                begin = end - take;
+                slots_[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(slots_[self].mutex);
+            slots_[self].begin = begin;
+            slots_[self].end = end;
+            return true;
+        }
+    }
+
+    void drain(std::size_t self, const Task& fn)
+    {
+        std::size_t task;
+        do {
+            while (pop(self, task))
+                fn(task, self);
+        } while (steal(self));
+    }
+
+    void worker(std::size_t index)
+    {
+        std::size_t seen = 0;
+        for (;;) {
+            const Task* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+                task = task_;
+            }
+            drain(index, *task);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Task* task_ = nullptr;
+    std::size_t pending_ = 0;
+    std::size_t generation_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace stabl
+
+#endif /* STABL_WORK_STEALING_POOL_H */